@@ -0,0 +1,95 @@
+#include "adaptive_thread_controller.h"
+#include <algorithm>
+#include <utility>
+
+AdaptiveThreadController::AdaptiveThreadController(Config config, int initialThreads)
+        : config_(std::move(config)) {
+    auto& levels = config_.threadLevels;
+    levels.erase(std::remove_if(levels.begin(), levels.end(), [](int threads) { return threads <= 0; }),
+                 levels.end());
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    if (levels.empty()) {
+        levels = { 1 };
+    }
+    config_.windowSteps = std::max(1, config_.windowSteps);
+    config_.staleWindows = std::max(1, config_.staleWindows);
+    reset(initialThreads);
+}
+
+void AdaptiveThreadController::reset(int initialThreads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& levels = config_.threadLevels;
+    auto initial = std::find(levels.begin(), levels.end(), initialThreads);
+    currentLevel_.store(initial != levels.end()
+                        ? static_cast<int>(initial - levels.begin())
+                        : static_cast<int>(levels.size() / 2));
+    windowSamples_.clear();
+    windowSamples_.reserve(static_cast<size_t>(config_.windowSteps));
+    levelLatencyMicros_.assign(levels.size(), 0);
+    levelMeasuredWindow_.assign(levels.size(), 0);
+    windowCount_ = 0;
+    probeUpNext_ = true;
+}
+
+bool AdaptiveThreadController::recordStep(int level, int64_t stepMicros) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (level != currentLevel_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    windowSamples_.push_back(stepMicros);
+    if (static_cast<int>(windowSamples_.size()) < config_.windowSteps) {
+        return false;
+    }
+    return decideLocked();
+}
+
+bool AdaptiveThreadController::decideLocked() {
+    const int current = currentLevel_.load(std::memory_order_relaxed);
+    const int levelCount = static_cast<int>(config_.threadLevels.size());
+
+    // 중앙값 — GC / 다른 앱에 의한 일시적 지연에 덜 민감
+    auto middle = windowSamples_.begin() + static_cast<std::ptrdiff_t>(windowSamples_.size() / 2);
+    std::nth_element(windowSamples_.begin(), middle, windowSamples_.end());
+    ++windowCount_;
+    levelLatencyMicros_[current] = *middle;
+    levelMeasuredWindow_[current] = windowCount_;
+    windowSamples_.clear();
+
+    auto isFresh = [this](int level) {
+        return levelMeasuredWindow_[level] > 0 &&
+               windowCount_ - levelMeasuredWindow_[level] <= config_.staleWindows;
+    };
+
+    // 이웃 단계의 측정값이 없거나 오래됐으면 한 window 동안 측정
+    const int firstProbe = probeUpNext_ ? current + 1 : current - 1;
+    const int secondProbe = probeUpNext_ ? current - 1 : current + 1;
+    for (int probe: { firstProbe, secondProbe }) {
+        if (probe >= 0 && probe < levelCount && !isFresh(probe)) {
+            probeUpNext_ = !probeUpNext_;
+            switchToLocked(probe, "probe");
+            return true;
+        }
+    }
+
+    int best = current;
+    for (int level = 0; level < levelCount; ++level) {
+        if (isFresh(level) && levelLatencyMicros_[level] < levelLatencyMicros_[best]) {
+            best = level;
+        }
+    }
+    if (best != current &&
+        levelLatencyMicros_[best] < levelLatencyMicros_[current] * (1.0 - config_.switchThreshold)) {
+        switchToLocked(best, "faster");
+        return true;
+    }
+    return false;
+}
+
+void AdaptiveThreadController::switchToLocked(int level, const char* reason) {
+    const int current = currentLevel_.load(std::memory_order_relaxed);
+    AIDEO_LOGI(LOG_TAG_ADAPTIVE_THREADS, "Threads %d -> %d (%s, step median %lld us)",
+               config_.threadLevels[current], config_.threadLevels[level], reason,
+               static_cast<long long>(levelLatencyMicros_[current]));
+    currentLevel_.store(level, std::memory_order_relaxed);
+}
@@ -0,0 +1,71 @@
+#ifndef AIDEO_ADAPTIVE_THREAD_CONTROLLER_H
+#define AIDEO_ADAPTIVE_THREAD_CONTROLLER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "logging.h"
+
+#define LOG_TAG_ADAPTIVE_THREADS "AdaptiveThreads"
+
+/**
+ * decode step 시간을 window 단위로 측정해, 미리 준비된 스레드 수 단계 중 가장 빠른 단계를 고름
+ *
+ * 발열로 big 코어 클럭이 떨어지거나 ASR / MediaCodec 이 코어를 점유하면 최적 스레드 수가 바뀜
+ * → 이웃 단계의 측정값이 오래되면 한 window 동안 다시 측정하고, 더 빠른 단계가 있으면 이동
+ */
+class AdaptiveThreadController {
+public:
+    struct Config {
+        // 후보 스레드 수 (정렬 및 중복 제거됨)
+        std::vector<int> threadLevels = { 1, 2, 4 };
+        // 이 step 수의 중앙값으로 단계를 평가
+        int windowSteps = 16;
+        // 다른 단계가 이 비율 이상 빠를 때만 이동 (측정 잡음으로 오가지 않도록)
+        double switchThreshold = 0.05;
+        // 측정값이 이 window 수보다 오래되면 이웃 단계를 다시 측정
+        int staleWindows = 8;
+    };
+
+    /**
+     * @param initialThreads : 시작 단계. 후보에 없으면 가운데 단계
+     */
+    AdaptiveThreadController(Config config, int initialThreads);
+
+    // 다음 step 에 사용할 단계 (threadLevels 의 인덱스). 임의의 스레드에서 호출 가능
+    int currentLevel() const { return currentLevel_.load(std::memory_order_relaxed); }
+
+    // 오름차순 후보 스레드 수
+    const std::vector<int>& threadLevels() const { return config_.threadLevels; }
+
+    /**
+     * [level] 단계로 실행한 cached step 1회의 시간 기록
+     *
+     * 그 사이 단계가 바뀌었으면 무시
+     * @return 이번 기록으로 단계가 바뀌었으면 true
+     */
+    bool recordStep(int level, int64_t stepMicros);
+
+    // 측정 기록을 지우고 [initialThreads] 단계부터 다시 시작
+    void reset(int initialThreads);
+
+private:
+    // window 가 찼을 때 호출 (mutex_ 보유)
+    bool decideLocked();
+
+    void switchToLocked(int level, const char* reason);
+
+    Config config_;
+    std::atomic<int> currentLevel_{ 0 };
+    std::mutex mutex_;
+    std::vector<int64_t> windowSamples_;
+    // 단계별 마지막 window 중앙값과 측정한 window 번호 (0 = 측정 전)
+    std::vector<int64_t> levelLatencyMicros_;
+    std::vector<int64_t> levelMeasuredWindow_;
+    int64_t windowCount_ = 0;
+    // 이웃 단계 재측정 시 위/아래를 번갈아 시도
+    bool probeUpNext_ = true;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "bump_arena_allocator.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // 새 블록의 최소 크기 (작은 텐서마다 블록이 늘어나지 않도록)
+    constexpr size_t kMinBlockBytes = 256 * 1024;
+}
+
+BumpArenaAllocator::BumpArenaAllocator(size_t initialCapacityBytes)
+        : memoryInfo_(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault)) {
+    if (initialCapacityBytes > 0) {
+        Block block = allocateBlock(alignUp(initialCapacityBytes, kAlignment));
+        if (block.data != nullptr) {
+            blocks_.push_back(block);
+        }
+    }
+}
+
+BumpArenaAllocator::~BumpArenaAllocator() {
+    for (auto& block: blocks_) {
+        std::free(block.data);
+    }
+}
+
+BumpArenaAllocator::Block BumpArenaAllocator::allocateBlock(size_t bytes) {
+    void* data = nullptr;
+    if (posix_memalign(&data, kAlignment, bytes) != 0) {
+        AIDEO_LOGE(LOG_TAG_BUMP_ARENA, "Failed to allocate arena block: %zu bytes", bytes);
+        return {};
+    }
+    return { static_cast<uint8_t*>(data), bytes };
+}
+
+void* BumpArenaAllocator::allocate(size_t bytes) {
+    const size_t alignedBytes = alignUp(std::max<size_t>(bytes, 1), kAlignment);
+
+    // 현재 블록에 자리가 없으면 다음 블록으로. rewind 로 되돌아온 경우 기존 블록을 재사용
+    while (blockIndex_ < blocks_.size() && offset_ + alignedBytes > blocks_[blockIndex_].size) {
+        ++blockIndex_;
+        offset_ = 0;
+    }
+
+    if (blockIndex_ == blocks_.size()) {
+        size_t blockBytes = std::max(alignedBytes, kMinBlockBytes);
+        if (!blocks_.empty()) {
+            blockBytes = std::max(blockBytes, blocks_.back().size);
+        }
+        Block block = allocateBlock(blockBytes);
+        if (block.data == nullptr) {
+            // 다음 allocate 가 마지막 블록부터 다시 시도하도록 위치를 되돌림
+            if (!blocks_.empty()) {
+                blockIndex_ = blocks_.size() - 1;
+                offset_ = blocks_.back().size;
+            } else {
+                blockIndex_ = 0;
+                offset_ = 0;
+            }
+            return nullptr;
+        }
+        blocks_.push_back(block);
+    }
+
+    void* p = blocks_[blockIndex_].data + offset_;
+    offset_ += alignedBytes;
+    peakBytes_ = std::max(peakBytes_, usedBytes());
+    return p;
+}
+
+void BumpArenaAllocator::rewind(const Marker& marker) {
+    if (marker.blockIndex > blocks_.size()) {
+        return;
+    }
+    blockIndex_ = marker.blockIndex;
+    offset_ = marker.offset;
+}
+
+bool BumpArenaAllocator::reset() {
+    blockIndex_ = 0;
+    offset_ = 0;
+    if (blocks_.size() <= 1) {
+        peakBytes_ = 0;
+        return false;
+    }
+
+    // 이번 요청의 최대 사용량을 한 블록으로 수용 → 다음 요청은 블록 추가 없이 진행
+    const size_t mergedBytes = alignUp(std::max(peakBytes_, capacityBytes()), kAlignment);
+    Block merged = allocateBlock(mergedBytes);
+    peakBytes_ = 0;
+    if (merged.data == nullptr) {
+        return false;
+    }
+    for (auto& block: blocks_) {
+        std::free(block.data);
+    }
+    blocks_.assign(1, merged);
+    return true;
+}
+
+size_t BumpArenaAllocator::capacityBytes() const {
+    size_t total = 0;
+    for (const auto& block: blocks_) {
+        total += block.size;
+    }
+    return total;
+}
+
+size_t BumpArenaAllocator::usedBytes() const {
+    size_t used = offset_;
+    for (size_t i = 0; i < blockIndex_ && i < blocks_.size(); ++i) {
+        used += blocks_[i].size;
+    }
+    return used;
+}
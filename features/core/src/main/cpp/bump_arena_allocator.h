@@ -0,0 +1,97 @@
+#ifndef AIDEO_BUMP_ARENA_ALLOCATOR_H
+#define AIDEO_BUMP_ARENA_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "logging.h"
+#include "onnxruntime_cxx_api.h"
+
+#define LOG_TAG_BUMP_ARENA "BumpArena"
+
+/**
+ * 번역 요청 하나 동안 입출력 텐서 버퍼를 미리 할당해 두는 bump arena
+ *
+ * - allocate() : 현재 블록에서 포인터만 전진. 부족하면 블록을 추가 (첫 요청/더 긴 입력에서만 발생)
+ * - 개별 해제 없음. 메모리는 rewind() / reset() 으로 한꺼번에 회수
+ * - reset() : 요청이 끝나면 호출. 블록이 여러 개면 전체 크기의 단일 블록으로 합쳐 다음 요청부터는 힙 할당이 없음
+ *
+ * ORT allocator 로 등록하지 않음 — allocate() 한 메모리에 Ort::Value::CreateTensor 로 텐서를 만들어
+ * IoBinding 에 출력 버퍼로 바인딩. 한 번에 한 스레드만 사용해야 함
+ */
+class BumpArenaAllocator {
+public:
+    // rewind() 로 되돌아갈 할당 위치
+    struct Marker {
+        size_t blockIndex = 0;
+        size_t offset = 0;
+    };
+
+    // 생성 시점의 위치를 기억했다가 소멸 시 rewind — 이 범위에서 만든 Ort::Value 는 먼저 해제되어야 함
+    class Checkpoint {
+    public:
+        explicit Checkpoint(BumpArenaAllocator& arena) : arena_(arena), marker_(arena.mark()) {}
+
+        ~Checkpoint() { arena_.rewind(marker_); }
+
+        Checkpoint(const Checkpoint&) = delete;
+
+        Checkpoint& operator=(const Checkpoint&) = delete;
+
+    private:
+        BumpArenaAllocator& arena_;
+        Marker marker_;
+    };
+
+    static constexpr size_t kAlignment = 64;
+
+    explicit BumpArenaAllocator(size_t initialCapacityBytes = 0);
+
+    ~BumpArenaAllocator();
+
+    BumpArenaAllocator(const BumpArenaAllocator&) = delete;
+
+    BumpArenaAllocator& operator=(const BumpArenaAllocator&) = delete;
+
+    // 실패 시 nullptr
+    void* allocate(size_t bytes);
+
+    // allocate() 로 받은 메모리에 Ort::Value 를 만들 때 사용 (CPU)
+    const Ort::MemoryInfo& memoryInfo() const { return memoryInfo_; }
+
+    Marker mark() const { return { blockIndex_, offset_ }; }
+
+    void rewind(const Marker& marker);
+
+    /**
+     * 모든 할당을 회수
+     *
+     * @return 블록을 합쳐 용량이 늘었으면 true
+     */
+    bool reset();
+
+    // 확보해 둔 블록 크기 합
+    size_t capacityBytes() const;
+
+    // 마지막 reset() 이후 동시에 사용된 최대 바이트
+    size_t peakBytes() const { return peakBytes_; }
+
+private:
+    struct Block {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    static Block allocateBlock(size_t bytes);
+
+    // 현재 위치까지 사용한 바이트 (앞선 블록은 전체를 사용한 것으로 계산)
+    size_t usedBytes() const;
+
+    Ort::MemoryInfo memoryInfo_;
+    std::vector<Block> blocks_;
+    size_t blockIndex_ = 0;
+    size_t offset_ = 0;
+    size_t peakBytes_ = 0;
+};
+
+#endif
@@ -0,0 +1,10 @@
+#include "cancellation_token.h"
+
+void CancellationToken::cancel() {
+    cancelled_.store(true, std::memory_order_release);
+    runOptions_.SetTerminate();
+}
+
+bool CancellationToken::isCancelled() const {
+    return cancelled_.load(std::memory_order_acquire);
+}
@@ -0,0 +1,26 @@
+#ifndef AIDEO_CANCELLATION_TOKEN_H
+#define AIDEO_CANCELLATION_TOKEN_H
+
+#include <atomic>
+#include "onnxruntime_cxx_api.h"
+
+// 진행 중인 추론을 다른 스레드에서 중단시키기 위한 핸들
+//   - Session::Run 도중 : runOptions() 의 terminate flag 로 ORT 가 Run 을 중단 (Ort::Exception)
+//   - decode step 사이 : isCancelled() 로 다음 step 진입 전에 중단
+// 요청마다 새로 생성 — 취소 상태를 되돌리지 않으므로 Run 중인 runOptions() 를 다른 요청이 건드리지 않음
+class CancellationToken {
+public:
+    // 임의의 스레드에서 호출 가능
+    void cancel();
+
+    bool isCancelled() const;
+
+    // 이 토큰으로 취소 가능한 Session::Run 에 전달
+    const Ort::RunOptions& runOptions() const { return runOptions_; }
+
+private:
+    std::atomic<bool> cancelled_{ false };
+    Ort::RunOptions runOptions_;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#include "cpu_topology.h"
+#include <algorithm>
+#include <fstream>
+#include <unistd.h>
+
+const std::vector<CpuTopology::Core>& CpuTopology::cores() {
+    static const std::vector<Core> cached = readCores();
+    return cached;
+}
+
+std::vector<CpuTopology::Core> CpuTopology::readCores() {
+    std::vector<Core> result;
+    long configuredCores = sysconf(_SC_NPROCESSORS_CONF);
+    for (int id = 0; id < configuredCores; ++id) {
+        std::ifstream file(
+                "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/cpufreq/cpuinfo_max_freq");
+        int64_t maxFrequencyKhz = 0;
+        if (file >> maxFrequencyKhz && maxFrequencyKhz > 0) {
+            result.push_back({ id, maxFrequencyKhz });
+        }
+    }
+
+    if (result.empty()) {
+        AIDEO_LOGW(LOG_TAG_CPU_TOPOLOGY, "CPU frequency information is not available");
+    }
+    return result;
+}
+
+std::vector<int> CpuTopology::fastestCores(int minCount) {
+    std::vector<Core> ranked = cores();
+    if (ranked.empty()) {
+        return {};
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const Core& a, const Core& b) {
+        return a.maxFrequencyKhz > b.maxFrequencyKhz;
+    });
+
+    // 같은 최대 주파수 = 같은 클러스터. 클러스터 중간에서 자르지 않음
+    std::vector<int> selected;
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        if (static_cast<int>(selected.size()) >= std::max(1, minCount) &&
+            ranked[i].maxFrequencyKhz != ranked[i - 1].maxFrequencyKhz) {
+            break;
+        }
+        selected.push_back(ranked[i].id);
+    }
+
+    if (selected.size() == ranked.size()) {
+        return {};
+    }
+    std::sort(selected.begin(), selected.end());
+    return selected;
+}
+
+std::string CpuTopology::intraOpAffinities(const ThreadAffinity& affinity, int intraOpThreads) {
+    const int workerCount = intraOpThreads - 1;
+    if (affinity.mode == ThreadAffinity::Mode::kNone || workerCount <= 0) {
+        return "";
+    }
+
+    std::vector<int> targetCores;
+    if (affinity.mode == ThreadAffinity::Mode::kExplicitCores) {
+        long configuredCores = sysconf(_SC_NPROCESSORS_CONF);
+        for (int core: affinity.cores) {
+            if (core < 0 || core >= configuredCores) {
+                AIDEO_LOGW(LOG_TAG_CPU_TOPOLOGY, "Ignoring invalid core id: %d", core);
+                return "";
+            }
+        }
+        targetCores = affinity.cores;
+    } else {
+        // Run 을 호출한 스레드도 연산하므로 워커 수가 아닌 전체 스레드 수만큼의 빠른 코어를 확보
+        targetCores = fastestCores(intraOpThreads);
+    }
+    if (targetCores.empty()) {
+        return "";
+    }
+
+    // ORT 의 processor id 는 1 부터 시작
+    std::string coreSet;
+    for (size_t i = 0; i < targetCores.size(); ++i) {
+        if (i > 0) {
+            coreSet += ",";
+        }
+        coreSet += std::to_string(targetCores[i] + 1);
+    }
+
+    std::string affinities;
+    const bool onePerWorker = static_cast<int>(targetCores.size()) == workerCount;
+    for (int worker = 0; worker < workerCount; ++worker) {
+        if (worker > 0) {
+            affinities += ";";
+        }
+        affinities += onePerWorker ? std::to_string(targetCores[worker] + 1) : coreSet;
+    }
+    return affinities;
+}
@@ -0,0 +1,73 @@
+#ifndef AIDEO_CPU_TOPOLOGY_H
+#define AIDEO_CPU_TOPOLOGY_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "logging.h"
+
+#define LOG_TAG_CPU_TOPOLOGY "CpuTopology"
+
+// 세션 전용 intra-op 스레드 풀의 워커 배치
+struct ThreadAffinity {
+    enum class Mode {
+        // 배치하지 않음 (OS 스케줄러에 맡김)
+        kNone,
+        // cores 에 지정한 코어에 고정
+        kExplicitCores,
+        // sysfs 최대 주파수가 높은 클러스터(big / prime 코어)에 고정
+        kFastestCores,
+    };
+
+    Mode mode = Mode::kNone;
+    // kExplicitCores 전용. 0 부터 시작하는 logical CPU id
+    std::vector<int> cores;
+
+    static ThreadAffinity explicitCores(std::vector<int> cores) {
+        ThreadAffinity affinity;
+        affinity.mode = Mode::kExplicitCores;
+        affinity.cores = std::move(cores);
+        return affinity;
+    }
+
+    static ThreadAffinity fastestCores() {
+        ThreadAffinity affinity;
+        affinity.mode = Mode::kFastestCores;
+        return affinity;
+    }
+};
+
+// /sys/devices/system/cpu 의 코어별 최대 주파수로 big.LITTLE 구성을 파악
+class CpuTopology {
+public:
+    struct Core {
+        int id = 0;
+        int64_t maxFrequencyKhz = 0;
+    };
+
+    // cpuinfo_max_freq 를 읽을 수 있는 코어 목록 (처음 호출 시 한 번만 읽음)
+    static const std::vector<Core>& cores();
+
+    /**
+     * 최대 주파수가 높은 클러스터부터 [minCount] 개 이상이 될 때까지 모은 코어 id
+     *
+     * 클러스터 단위로 모으므로 prime 코어가 1개뿐이면 다음 big 클러스터까지 포함됨
+     * @return 주파수 정보를 읽을 수 없거나 결과가 전체 코어와 같으면(고정할 의미가 없음) 빈 벡터
+     */
+    static std::vector<int> fastestCores(int minCount);
+
+    /**
+     * session.intra_op_thread_affinities 값 생성 — 워커 (intraOpThreads - 1)개의 배치
+     *
+     * ORT 는 Run 을 호출한 스레드는 고정하지 않으므로 워커만 대상.
+     * 코어 수가 워커 수와 같으면 워커마다 코어 하나, 아니면 모든 워커를 코어 집합 전체에 고정
+     * @return 배치하지 않아야 하면 빈 문자열
+     */
+    static std::string intraOpAffinities(const ThreadAffinity& affinity, int intraOpThreads);
+
+private:
+    static std::vector<Core> readCores();
+};
+
+#endif
@@ -1,41 +1,36 @@
 #include "encoder_decoder_with_past.h"
+#include "load_task_group.h"
+#include "memory_usage.h"
 #include "path_utils.h"
+#include <algorithm>
+#include <chrono>
 #include <exception>
-#include <regex>
 #include <utility>
 
-EncoderDecoderWithPast::EncoderDecoderWithPast(
-        int numDecoderLayers,
-        int numHeads,
-        int hiddenSize,
-        int64_t vocabSize
-) : EncoderDecoderWithPast(
-        numDecoderLayers,
-        numHeads,
-        hiddenSize,
-        vocabSize,
+EncoderDecoderWithPast::EncoderDecoderWithPast()
+        : EncoderDecoderWithPast(ModelDimensions{}) {}
+
+EncoderDecoderWithPast::EncoderDecoderWithPast(const ModelDimensions& expectedDimensions)
+        : EncoderDecoderWithPast(
+        expectedDimensions,
         EncoderIoConfig{},
         DecoderIoConfig{},
         DecoderWithPastIoConfig{},
         std::make_unique<GreedyTokenSelector>()) {}
 
 EncoderDecoderWithPast::EncoderDecoderWithPast(
-        int numDecoderLayers,
-        int numHeads,
-        int hiddenSize,
-        int64_t vocabSize,
+        const ModelDimensions& expectedDimensions,
         EncoderIoConfig&& encoderIoConfig,
         DecoderIoConfig&& decoderIoConfig,
         DecoderWithPastIoConfig&& decoderWithPastIoConfig,
         std::unique_ptr<TokenSelector>&& tokenSelector
 ) : tokenSelector_(std::move(tokenSelector)),
+    // encoder, decoder, decoder_with_past 는 번갈아 실행될 뿐 동시에 실행되지 않으므로 하나의 global 스레드 풀을 공유
+    inference_(OnnxInference::ThreadingConfig{ OnnxInference::ThreadPoolMode::kGlobal }),
     encoderIoConfig_(std::move(encoderIoConfig)),
     decoderIoConfig_(std::move(decoderIoConfig)),
     decoderWithPastIoConfig_(std::move(decoderWithPastIoConfig)),
-    numDecoderLayers_(numDecoderLayers),
-    numHeads_(numHeads),
-    hiddenSize_(hiddenSize),
-    vocabSize_(vocabSize) {}
+    expectedDimensions_(expectedDimensions) {}
 
 EncoderDecoderWithPast::~EncoderDecoderWithPast() {
     release();
@@ -46,26 +41,454 @@ bool EncoderDecoderWithPast::load(
         const char* decoderPath,
         const char* decoderWithPastPath
 ) {
-    if (!loadModelSession(
-            kEncoderSessionKey, encoderPath, loadedEncoderPath_, "encoder model")) {
+    return load(encoderPath, decoderPath, decoderWithPastPath, LoadOptions{});
+}
+
+bool EncoderDecoderWithPast::load(
+        const char* encoderPath,
+        const char* decoderPath,
+        const char* decoderWithPastPath,
+        const LoadOptions& options
+) {
+    const auto& profiles = options.profiles;
+
+    // 세 세션은 첫 generateSingle() 전까지 서로 독립적 → 병렬 생성. 하나라도 실패하면 load 실패
+    LoadTaskGroup taskGroup("EncoderDecoderWithPast");
+    taskGroup.add("encoder", [&]() {
+        return loadModelSession(
+                kEncoderSessionKey, encoderPath, loadedEncoderPath_, "encoder model",
+                profiles.encoder);
+    });
+    taskGroup.add("decoder", [&]() {
+        return loadModelSession(
+                kDecoderSessionKey, decoderPath, loadedDecoderPath_, "decoder model",
+                profiles.decoder);
+    });
+    taskGroup.add("decoder_with_past", [&]() {
+        return loadModelSession(
+                kDecoderWithPastSessionKey,
+                decoderWithPastPath,
+                loadedDecoderWithPastPath_,
+                "decoder with past model",
+                profiles.decoderWithPast);
+    });
+    int64_t residentBytesBefore = aideo::residentSetBytes();
+    if (!taskGroup.run()) {
         return false;
     }
-    if (!loadModelSession(
-            kDecoderSessionKey, decoderPath, loadedDecoderPath_, "decoder model")) {
+
+    // 이전에 loadMerged() 로 로드된 merged decoder 는 더 이상 사용하지 않음
+    if (useMergedDecoder_.exchange(false)) {
+        inference_.releaseSession(kMergedDecoderSessionKey);
+        loadedMergedDecoderPath_.clear();
+    }
+    return completeLoad(options, residentBytesBefore);
+}
+
+bool EncoderDecoderWithPast::loadMerged(
+        const char* encoderPath,
+        const char* mergedDecoderPath
+) {
+    return loadMerged(encoderPath, mergedDecoderPath, LoadOptions{});
+}
+
+bool EncoderDecoderWithPast::loadMerged(
+        const char* encoderPath,
+        const char* mergedDecoderPath,
+        const LoadOptions& options
+) {
+    const auto& profiles = options.profiles;
+
+    LoadTaskGroup taskGroup("EncoderDecoderMerged");
+    taskGroup.add("encoder", [&]() {
+        return loadModelSession(
+                kEncoderSessionKey, encoderPath, loadedEncoderPath_, "encoder model",
+                profiles.encoder);
+    });
+    taskGroup.add("decoder_merged", [&]() {
+        return loadModelSession(
+                kMergedDecoderSessionKey, mergedDecoderPath, loadedMergedDecoderPath_,
+                "merged decoder model", profiles.mergedDecoder);
+    });
+    int64_t residentBytesBefore = aideo::residentSetBytes();
+    if (!taskGroup.run()) {
+        return false;
+    }
+
+    // 분리형 decoder 세션은 merged decoder 와 같은 가중치를 한 벌 더 갖고 있으므로 해제
+    if (!useMergedDecoder_.exchange(true)) {
+        inference_.releaseSession(kDecoderSessionKey);
+        inference_.releaseSession(kDecoderWithPastSessionKey);
+        loadedDecoderPath_.clear();
+        loadedDecoderWithPastPath_.clear();
+    }
+    return completeLoad(options, residentBytesBefore);
+}
+
+bool EncoderDecoderWithPast::completeLoad(const LoadOptions& options, int64_t residentBytesBefore) {
+    logMemoryReport(aideo::residentSetBytes() - residentBytesBefore);
+
+    if (!inferModelDimensions() || !buildSessionBindings()) {
         return false;
     }
-    return loadModelSession(
-            kDecoderWithPastSessionKey,
-            decoderWithPastPath,
-            loadedDecoderWithPastPath_,
-            "decoder with past model");
+
+    if (options.adaptiveThreading) {
+        threadLevelConfig_ = options.threadLevels;
+        if (!loadThreadLevelSessions(useMergedDecoder_.load() ? options.profiles.mergedDecoder
+                                                             : options.profiles.decoderWithPast)) {
+            return false;
+        }
+    } else {
+        releaseThreadLevelSessions();
+    }
+
+    if (options.warmUp.enabled && needsWarmUp_.load()) {
+        auto startedAt = std::chrono::steady_clock::now();
+        if (warmUp(options.warmUp)) {
+            needsWarmUp_.store(false);
+            AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "Warm-up done in %lld ms",
+                       static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - startedAt).count()));
+        } else {
+            AIDEO_LOGW(LOG_TAG_ENC_DEC_WITH_PAST, "Warm-up failed; first translation will be slower");
+        }
+    }
+    return true;
+}
+
+const char* EncoderDecoderWithPast::firstStepSessionKey() const {
+    return useMergedDecoder_.load() ? kMergedDecoderSessionKey : kDecoderSessionKey;
+}
+
+const char* EncoderDecoderWithPast::cachedStepSessionKey() const {
+    return useMergedDecoder_.load() ? kMergedDecoderSessionKey : kDecoderWithPastSessionKey;
+}
+
+SessionProfile EncoderDecoderWithPast::profileForThreadLevel(const SessionProfile& base, int threads) {
+    SessionProfile profile = base;
+    if (profile.executionProvider == SessionProfile::ExecutionProvider::kXnnpackWithCpuFallback) {
+        profile.xnnpackThreads = threads;
+    } else {
+        profile.useGlobalThreadPool = false;
+        profile.intraOpThreads = threads;
+    }
+    return profile;
+}
+
+bool EncoderDecoderWithPast::loadThreadLevelSessions(const SessionProfile& base) {
+    releaseThreadLevelSessions();
+
+    const bool merged = useMergedDecoder_.load();
+    const std::string modelPath = merged ? loadedMergedDecoderPath_ : loadedDecoderWithPastPath_;
+    const std::string baseKey = cachedStepSessionKey();
+    int baseThreads = 0;
+    if (base.executionProvider == SessionProfile::ExecutionProvider::kXnnpackWithCpuFallback) {
+        baseThreads = base.xnnpackThreads;
+    } else if (!base.useGlobalThreadPool) {
+        baseThreads = base.intraOpThreads;
+    }
+
+    // 기준 세션은 이미 로드되어 최적화 모델 캐시 기록까지 끝난 상태 → 단계별 세션은 그 ORT format 파일을 mmap 해 로드
+    // 단계별 세션은 캐시를 거치지 않으므로 같은 캐시 파일을 동시에 기록하지 않음
+    // 캐시를 쓸 수 없으면 (XNNPACK, 캐시 디렉터리 불가 등) 원본 모델을 다시 읽어 단계마다 가중치를 한 벌씩 가짐
+    const std::string ortModelPath = inference_.ortModelPath(baseKey);
+    const std::string& levelModelPath = ortModelPath.empty() ? modelPath : ortModelPath;
+    if (ortModelPath.empty()) {
+        AIDEO_LOGW(LOG_TAG_ENC_DEC_WITH_PAST,
+                   "No ORT format model for %s; thread level sessions load their own weights", baseKey.c_str());
+    }
+
+    auto controller = std::make_unique<AdaptiveThreadController>(threadLevelConfig_, baseThreads);
+    std::vector<std::string> sessionKeys;
+    for (int threads: controller->threadLevels()) {
+        if (threads == baseThreads) {
+            sessionKeys.push_back(baseKey);
+            continue;
+        }
+        std::string sessionKey = baseKey + "@t" + std::to_string(threads);
+        sessionKeys.push_back(sessionKey);
+        SessionProfile profile = profileForThreadLevel(base, threads).withOptimizedModelCache(false);
+        if (!ortModelPath.empty()) {
+            // 이미 최적화가 끝난 그래프. mmap 한 initializer 는 page cache 를 공유하고, prepack 결과는 공유 저장소에서 재사용
+            profile.graphOptimizationLevel = GraphOptimizationLevel::ORT_DISABLE_ALL;
+            profile = profile.withMemoryMappedModel();
+        }
+
+        // 병렬로 만들면 세션마다 RSS 가 동시에 치솟으므로 하나씩 로드
+        if (!inference_.loadSession(sessionKey, levelModelPath.c_str(), sessionKey.c_str(), profile)) {
+            for (const auto& loadedKey: sessionKeys) {
+                if (loadedKey != baseKey) {
+                    inference_.releaseSession(loadedKey);
+                }
+            }
+            return false;
+        }
+    }
+
+    threadLevelSessionKeys_ = std::move(sessionKeys);
+    threadController_ = std::move(controller);
+    return true;
+}
+
+void EncoderDecoderWithPast::releaseThreadLevelSessions() {
+    for (const auto& sessionKey: threadLevelSessionKeys_) {
+        if (sessionKey != kDecoderWithPastSessionKey && sessionKey != kMergedDecoderSessionKey) {
+            inference_.releaseSession(sessionKey);
+        }
+    }
+    threadLevelSessionKeys_.clear();
+    threadController_.reset();
+}
+
+const char* EncoderDecoderWithPast::activeCachedStepSessionKey(int& level) const {
+    if (!threadController_) {
+        level = -1;
+        return cachedStepSessionKey();
+    }
+    level = threadController_->currentLevel();
+    return threadLevelSessionKeys_[static_cast<size_t>(level)].c_str();
+}
+
+bool EncoderDecoderWithPast::bindDummyPastKeyValues(BumpArenaAllocator& arena, GenerationState& state) const {
+    // 길이 0 tensor 는 일부 kernel 의 shape 검사에서 실패하므로 Optimum 과 같이 sequence 길이 1 사용
+    // 값은 읽히지 않으므로 모든 슬롯이 같은 0 버퍼를 가리킴
+    const std::vector<int64_t> shape = { 1, dimensions_.numHeads, 1, dimensions_.headDim };
+    const auto elementCount = static_cast<size_t>(dimensions_.numHeads) * dimensions_.headDim;
+    auto* data = static_cast<float*>(arena.allocate(elementCount * sizeof(float)));
+    if (data == nullptr) {
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Failed to allocate dummy past key values");
+        return false;
+    }
+    std::fill(data, data + elementCount, 0.0f);
+    for (auto& past: state.pastKeyValues) {
+        past = Ort::Value::CreateTensor<float>(
+                arena.memoryInfo(), data, elementCount, shape.data(), shape.size());
+    }
+    return true;
+}
+
+bool EncoderDecoderWithPast::inferModelDimensions() {
+    auto encoderSession = inference_.getSession(kEncoderSessionKey, "Encoder");
+    auto decoderSession = inference_.getSession(firstStepSessionKey(), "Decoder");
+    auto decoderWithPastSession = inference_.getSession(cachedStepSessionKey(), "DecoderWithPast");
+    if (!encoderSession || !decoderSession || !decoderWithPastSession) {
+        return false;
+    }
+
+    // metadata 에서 읽지 못한 값은 0 (symbolic dimension 은 GetShape() 에서 -1)
+    ModelDimensions inferred;
+    Ort::AllocatorWithDefaultOptions allocator;
+    try {
+        const auto& pastPrefix = decoderWithPastIoConfig_.pastKeyValuesPrefix;
+        const std::string decoderKeySuffix = "." + decoderWithPastIoConfig_.decoderKey;
+        int maxLayerIndex = -1;
+        for (size_t i = 0; i < decoderWithPastSession->GetInputCount(); ++i) {
+            std::string name(decoderWithPastSession->GetInputNameAllocated(i, allocator).get());
+            if (name.compare(0, pastPrefix.size(), pastPrefix) != 0) {
+                continue;
+            }
+            // "past_key_values.N.decoder.key" → N
+            size_t indexEnd = name.find('.', pastPrefix.size());
+            if (indexEnd == std::string::npos || indexEnd == pastPrefix.size()) {
+                continue;
+            }
+            int layerIndex = std::stoi(name.substr(pastPrefix.size(), indexEnd - pastPrefix.size()));
+            maxLayerIndex = std::max(maxLayerIndex, layerIndex);
+
+            if (name.compare(indexEnd, std::string::npos, decoderKeySuffix) == 0 && inferred.numHeads <= 0) {
+                auto shape = decoderWithPastSession->GetInputTypeInfo(i)
+                        .GetTensorTypeAndShapeInfo().GetShape();
+                if (shape.size() == 4) {
+                    inferred.numHeads = static_cast<int>(std::max<int64_t>(0, shape[1]));
+                    inferred.headDim = static_cast<int>(std::max<int64_t>(0, shape[3]));
+                }
+            }
+        }
+        inferred.numDecoderLayers = maxLayerIndex + 1;
+
+        for (size_t i = 0; i < encoderSession->GetOutputCount(); ++i) {
+            std::string name(encoderSession->GetOutputNameAllocated(i, allocator).get());
+            if (name != encoderIoConfig_.lastHiddenState) {
+                continue;
+            }
+            auto shape = encoderSession->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+            if (shape.size() == 3) {
+                inferred.hiddenSize = static_cast<int>(std::max<int64_t>(0, shape[2]));
+            }
+        }
+
+        for (size_t i = 0; i < decoderSession->GetOutputCount(); ++i) {
+            std::string name(decoderSession->GetOutputNameAllocated(i, allocator).get());
+            if (name != decoderIoConfig_.logits && name != decoderWithPastIoConfig_.logits) {
+                continue;
+            }
+            auto shape = decoderSession->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+            if (shape.size() == 3) {
+                inferred.vocabSize = std::max<int64_t>(0, shape[2]);
+            }
+        }
+    } catch (const std::exception& e) {
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Failed to read session metadata: %s", e.what());
+        return false;
+    }
+
+    if (inferred.hiddenSize <= 0 && inferred.numHeads > 0 && inferred.headDim > 0) {
+        inferred.hiddenSize = inferred.numHeads * inferred.headDim;
+    }
+
+    // 명시된 값과 추론 값이 모두 있으면 일치해야 하고, 둘 다 없으면 확정 불가
+    bool resolved = true;
+    auto resolve = [&resolved](const char* field, int64_t inferredValue, int64_t expectedValue) {
+        if (inferredValue > 0 && expectedValue > 0 && inferredValue != expectedValue) {
+            AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Model %s mismatch: model=%lld, configured=%lld",
+                       field, static_cast<long long>(inferredValue),
+                       static_cast<long long>(expectedValue));
+            resolved = false;
+        } else if (inferredValue <= 0 && expectedValue <= 0) {
+            AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Cannot determine model %s", field);
+            resolved = false;
+        }
+        return inferredValue > 0 ? inferredValue : expectedValue;
+    };
+
+    ModelDimensions dimensions;
+    dimensions.numDecoderLayers = static_cast<int>(resolve(
+            "decoder layers", inferred.numDecoderLayers, expectedDimensions_.numDecoderLayers));
+    dimensions.numHeads = static_cast<int>(resolve(
+            "attention heads", inferred.numHeads, expectedDimensions_.numHeads));
+    dimensions.headDim = static_cast<int>(resolve(
+            "head dim", inferred.headDim, expectedDimensions_.headDim));
+    dimensions.hiddenSize = static_cast<int>(resolve(
+            "hidden size", inferred.hiddenSize, expectedDimensions_.hiddenSize));
+    dimensions.vocabSize = resolve("vocab size", inferred.vocabSize, expectedDimensions_.vocabSize);
+    if (!resolved) {
+        return false;
+    }
+
+    if (dimensions.numHeads * dimensions.headDim != dimensions.hiddenSize) {
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Inconsistent model dimensions: %d heads * %d != hidden %d",
+                   dimensions.numHeads, dimensions.headDim, dimensions.hiddenSize);
+        return false;
+    }
+
+    dimensions_ = dimensions;
+    AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "Model dimensions: layers=%d, heads=%d, headDim=%d, hidden=%d, vocab=%lld",
+               dimensions_.numDecoderLayers, dimensions_.numHeads, dimensions_.headDim,
+               dimensions_.hiddenSize, static_cast<long long>(dimensions_.vocabSize));
+    return true;
+}
+
+bool EncoderDecoderWithPast::warmUp(const WarmUpConfig& config) {
+    auto encoderLength = static_cast<size_t>(std::max(1, config.encoderLength));
+    std::vector<int64_t> encoderInputIds(encoderLength, config.tokenId);
+    std::vector<int64_t> encoderAttentionMask(encoderLength, 1);
+    std::vector<int64_t> initialDecoderInputIds = { config.tokenId, config.tokenId };
+
+    // eosTokenId 를 존재하지 않는 토큰(-1)으로 주어 정확히 (1 + decoderWithPastSteps) 회 디코딩
+    auto tokens = generateSingle(
+            encoderInputIds, encoderAttentionMask, initialDecoderInputIds, -1,
+            std::max(0, config.decoderWithPastSteps) + 1);
+    return !tokens.empty();
+}
+
+double EncoderDecoderWithPast::measureGenerationMs(const WarmUpConfig& shape, int iterations) {
+    if (!warmUp(shape)) {
+        return -1.0;
+    }
+
+    iterations = std::max(1, iterations);
+    auto startedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        if (!warmUp(shape)) {
+            return -1.0;
+        }
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startedAt;
+    return elapsed.count() / iterations;
+}
+
+EncoderDecoderWithPast::CrossAttentionBenchmark EncoderDecoderWithPast::benchmarkCrossAttention(
+        const WarmUpConfig& shape,
+        int iterations) {
+    CrossAttentionBenchmark result;
+    const auto encoderLength = static_cast<int64_t>(std::max(1, shape.encoderLength));
+    const auto slotBytes = static_cast<int64_t>(dimensions_.numHeads) * encoderLength *
+                           dimensions_.headDim * static_cast<int64_t>(sizeof(float));
+    result.pinnedBytes = static_cast<int64_t>(dimensions_.numDecoderLayers) * 2 * slotBytes;
+    // cached step 세션이 내보내는 encoder present 는 받지 않으므로 그만큼 출력·복사가 줄어듦
+    for (const auto& slot: cachedStepBinding_.outputs) {
+        if (slot.role == IoRole::kPresentKeyValue && slot.kvSlot % 4 >= 2) {
+            result.savedBytesPerStep += slotBytes;
+        }
+    }
+    result.stepMs = measureDecodeStepMs(shape, iterations);
+
+    const int decodeSteps = std::max(1, shape.decoderWithPastSteps);
+    AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST,
+               "Cross-attention K/V (encoder %lld tokens): %lld bytes pinned once, "
+               "%lld bytes/step not re-emitted (%lld bytes over %d steps), step %.2f ms",
+               static_cast<long long>(encoderLength), static_cast<long long>(result.pinnedBytes),
+               static_cast<long long>(result.savedBytesPerStep),
+               static_cast<long long>(result.savedBytesPerStep * decodeSteps), decodeSteps, result.stepMs);
+    return result;
+}
+
+double EncoderDecoderWithPast::measureDecodeStepMs(const WarmUpConfig& shape, int iterations) {
+    const int decodeSteps = std::max(1, shape.decoderWithPastSteps);
+    WarmUpConfig withDecodeSteps = shape;
+    withDecodeSteps.decoderWithPastSteps = decodeSteps;
+    WarmUpConfig firstStepOnly = shape;
+    firstStepOnly.decoderWithPastSteps = 0;
+
+    double generationMs = measureGenerationMs(withDecodeSteps, iterations);
+    double firstStepMs = measureGenerationMs(firstStepOnly, iterations);
+    if (generationMs < 0.0 || firstStepMs < 0.0) {
+        return -1.0;
+    }
+    return std::max(0.0, generationMs - firstStepMs) / decodeSteps;
+}
+
+bool EncoderDecoderWithPast::reloadCachedStepSession(const SessionProfile& profile) {
+    const bool merged = useMergedDecoder_.load();
+    const std::string modelPath = merged ? loadedMergedDecoderPath_ : loadedDecoderWithPastPath_;
+    if (modelPath.empty()) {
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "No cached step session to reload");
+        return false;
+    }
+
+    // 같은 키로 다시 등록 — 사용 중인 이전 세션은 lease 가 반납될 때 해제됨
+    if (!inference_.loadSession(cachedStepSessionKey(), modelPath.c_str(),
+                                merged ? "merged decoder model" : "decoder with past model",
+                                profile)) {
+        return false;
+    }
+    needsWarmUp_.store(true);
+    // 스레드 단계별 세션도 같은 설정으로 다시 생성
+    if (threadController_ && !loadThreadLevelSessions(profile)) {
+        return false;
+    }
+    return true;
+}
+
+void EncoderDecoderWithPast::logMemoryReport(int64_t totalResidentBytesDelta) const {
+    // 병렬 로드 시 세션별 RSS 증가분은 근사값. decoder/decoder_with_past 의 prepack 공유 효과는
+    // sharePrepackedWeights 를 끈 프로필과의 총 증가량 비교로 확인
+    for (const auto& report: inference_.memoryReport()) {
+        AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "  %s: RSS %+lld KB%s",
+                   report.sessionKey.c_str(),
+                   static_cast<long long>(report.residentBytesDelta / 1024),
+                   report.sharesPrepackedWeights ? " (shared prepacked weights)" : "");
+    }
+    AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "Sessions loaded: RSS %+lld KB",
+               static_cast<long long>(totalResidentBytesDelta / 1024));
 }
 
 bool EncoderDecoderWithPast::loadModelSession(
         const char* sessionKey,
         const char* modelPath,
         std::string& loadedPath,
-        const char* modelName
+        const char* modelName,
+        const SessionProfile& profile
 ) {
     if (!aideo::isInvalidPath(modelPath) &&
         loadedPath == modelPath &&
@@ -73,398 +496,611 @@ bool EncoderDecoderWithPast::loadModelSession(
         return true;
     }
 
-    if (!inference_.loadSession(sessionKey, modelPath, modelName)) {
+    if (!inference_.loadSession(sessionKey, modelPath, modelName, profile)) {
         return false;
     }
+    needsWarmUp_.store(true);
 
     loadedPath = modelPath;
     return true;
 }
 
 void EncoderDecoderWithPast::release() {
+    threadLevelSessionKeys_.clear();
+    threadController_.reset();
     inference_.release();
+    needsWarmUp_.store(true);
+    useMergedDecoder_.store(false);
     loadedEncoderPath_.clear();
     loadedDecoderPath_.clear();
     loadedDecoderWithPastPath_.clear();
+    loadedMergedDecoderPath_.clear();
+    {
+        std::lock_guard<std::mutex> lock(arenaPoolMutex_);
+        arenaPool_.clear();
+    }
+    std::lock_guard<std::mutex> lock(kvCachePoolMutex_);
+    kvCachePool_.clear();
 }
 
-std::pair<int, int> EncoderDecoderWithPast::parseKvOutputName(const std::string& name) {
-    static const std::regex pattern(R"(present\.(\d+)\.(decoder|encoder)\.(key|value))");
-    std::smatch match;
-    if (std::regex_search(name, match, pattern) && match.size() == 4) {
-        int layerIdx = std::stoi(match[1].str());
-        bool isEncoder = (match[2].str() == "encoder");
-        bool isValue = (match[3].str() == "value");
-        int typeOffset = (isEncoder ? 2 : 0) + (isValue ? 1 : 0);
-        return { layerIdx, typeOffset };
-    }
-    return { -1, -1 };
+void EncoderDecoderWithPast::setMemoryBudget(int64_t budgetBytes) {
+    inference_.setMemoryBudget(budgetBytes);
 }
 
-std::vector<float> EncoderDecoderWithPast::runEncoder(
-        const std::vector<int64_t>& inputIds,
-        const std::vector<int64_t>& attentionMask,
-        int64_t batchSize,
-        int64_t seqLength
-) {
+OnnxInference::SessionCacheStats EncoderDecoderWithPast::sessionCacheStats() const {
+    return inference_.sessionCacheStats();
+}
 
-    std::vector<float> encoderHiddenStates; // [batch_size, seq_len, hidden_size]
-    auto* encoderSession = inference_.getSession(kEncoderSessionKey, "Encoder");
-    if (!encoderSession) {
-        return encoderHiddenStates;
+bool EncoderDecoderWithPast::startProfiling(const OnnxInference::ProfilingConfig& config) {
+    return inference_.startProfiling(config);
+}
+
+std::vector<OrtProfileSummary> EncoderDecoderWithPast::profilingSummaries() const {
+    return inference_.profilingSummaries();
+}
+
+std::vector<SessionRunStats> EncoderDecoderWithPast::runStats() const {
+    return inference_.runStats();
+}
+
+void EncoderDecoderWithPast::resetRunStats() {
+    inference_.resetRunStats();
+}
+
+std::unique_ptr<BumpArenaAllocator> EncoderDecoderWithPast::acquireArena() {
+    {
+        std::lock_guard<std::mutex> lock(arenaPoolMutex_);
+        if (!arenaPool_.empty()) {
+            auto arena = std::move(arenaPool_.back());
+            arenaPool_.pop_back();
+            return arena;
+        }
+    }
+    return std::make_unique<BumpArenaAllocator>();
+}
+
+void EncoderDecoderWithPast::releaseArena(std::unique_ptr<BumpArenaAllocator> arena) {
+    const size_t peakBytes = arena->peakBytes();
+    if (arena->reset()) {
+        AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "Output arena grown: capacity=%zu bytes, peak=%zu bytes",
+                   arena->capacityBytes(), peakBytes);
     }
+    std::lock_guard<std::mutex> lock(arenaPoolMutex_);
+    arenaPool_.push_back(std::move(arena));
+}
 
-    Ort::AllocatorWithDefaultOptions allocator;
+std::unique_ptr<KvCacheBuffers> EncoderDecoderWithPast::acquireKvCache() {
+    {
+        std::lock_guard<std::mutex> lock(kvCachePoolMutex_);
+        if (!kvCachePool_.empty()) {
+            auto kvCache = std::move(kvCachePool_.back());
+            kvCachePool_.pop_back();
+            return kvCache;
+        }
+    }
+    return std::make_unique<KvCacheBuffers>();
+}
 
-    try {
-        auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-        std::vector<int64_t> inputShape = { batchSize, seqLength };
+void EncoderDecoderWithPast::releaseKvCache(std::unique_ptr<KvCacheBuffers> kvCache) {
+    std::lock_guard<std::mutex> lock(kvCachePoolMutex_);
+    kvCachePool_.push_back(std::move(kvCache));
+}
 
-        // 동적으로 모델의 입/출력 구조를 확인하고, 각 입/출력의(Input/Output) 인자 이름들을 가져옴
-        // Session::Run() 인자로 inputNames 가 const char* 로 필요하고, 해당 포인터의 수명 주기 연장 용도로 스마트 포인터 객체를 따로 보유
-        std::vector<Ort::AllocatedStringPtr> inputNamePtrs;
-        std::vector<const char*> inputNames;
-        for (size_t i = 0; i < encoderSession->GetInputCount(); ++i) {
-            inputNamePtrs.push_back(encoderSession->GetInputNameAllocated(i, allocator));
-            inputNames.push_back(inputNamePtrs.back().get());
+Ort::Value EncoderDecoderWithPast::arenaOutputTensor(
+        BumpArenaAllocator& arena,
+        std::initializer_list<int64_t> shape) {
+    size_t elementCount = 1;
+    for (int64_t dim: shape) {
+        if (dim <= 0) {
+            return Ort::Value{ nullptr };
         }
+        elementCount *= static_cast<size_t>(dim);
+    }
 
-        std::vector<Ort::AllocatedStringPtr> outputNamePtrs;
-        std::vector<const char*> outputNames;
-        for (size_t i = 0; i < encoderSession->GetOutputCount(); ++i) {
-            outputNamePtrs.push_back(encoderSession->GetOutputNameAllocated(i, allocator));
-            outputNames.push_back(outputNamePtrs.back().get());
-        }
-
-        std::vector<Ort::Value> inputTensors;
-        for (auto& inputName: inputNames) {
-            std::string name(inputName);
-            if (name == encoderIoConfig_.inputIds) {
-                inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
-                        memoryInfo,
-                        const_cast<int64_t*>(inputIds.data()), inputIds.size(),
-                        inputShape.data(), inputShape.size()
-                ));
-            } else if (name == encoderIoConfig_.attentionMask) {
-                inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
-                        memoryInfo,
-                        const_cast<int64_t*>(attentionMask.data()), attentionMask.size(),
-                        inputShape.data(), inputShape.size()
-                ));
+    auto* data = static_cast<float*>(arena.allocate(elementCount * sizeof(float)));
+    if (data == nullptr) {
+        return Ort::Value{ nullptr };
+    }
+    return Ort::Value::CreateTensor<float>(
+            arena.memoryInfo(), data, elementCount, shape.begin(), shape.size());
+}
+
+void EncoderDecoderWithPast::bindOutput(
+        Ort::IoBinding& ioBinding,
+        const char* name,
+        const Ort::Value& preallocated,
+        const Ort::MemoryInfo& memoryInfo) {
+    if (preallocated) {
+        ioBinding.BindOutput(name, preallocated);
+    } else {
+        ioBinding.BindOutput(name, memoryInfo);
+    }
+}
+
+int EncoderDecoderWithPast::parseKvSlot(const std::string& name, const std::string& prefix) const {
+    // "<prefix>N.{decoder|encoder}.{key|value}" → N * 4 + 타입 오프셋
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+        return -1;
+    }
+    size_t indexEnd = name.find('.', prefix.size());
+    if (indexEnd == std::string::npos || indexEnd == prefix.size()) {
+        return -1;
+    }
+    const std::string layer = name.substr(prefix.size(), indexEnd - prefix.size());
+    if (layer.find_first_not_of("0123456789") != std::string::npos) {
+        return -1;
+    }
+
+    const std::string type = name.substr(indexEnd + 1);
+    int typeOffset = -1;
+    if (type == decoderWithPastIoConfig_.decoderKey) {
+        typeOffset = 0;
+    } else if (type == decoderWithPastIoConfig_.decoderValue) {
+        typeOffset = 1;
+    } else if (type == decoderWithPastIoConfig_.encoderKey) {
+        typeOffset = 2;
+    } else if (type == decoderWithPastIoConfig_.encoderValue) {
+        typeOffset = 3;
+    }
+    if (typeOffset < 0) {
+        return -1;
+    }
+    return std::stoi(layer) * 4 + typeOffset;
+}
+
+bool EncoderDecoderWithPast::buildSessionBinding(
+        const char* sessionKey,
+        SessionKind kind,
+        SessionBinding& binding) {
+    binding = SessionBinding{};
+    auto session = inference_.getSession(sessionKey, sessionKey);
+    if (!session) {
+        return false;
+    }
+
+    const int kvSlotCount = dimensions_.numDecoderLayers * 4;
+    Ort::AllocatorWithDefaultOptions allocator;
+    try {
+        for (size_t i = 0; i < session->GetInputCount(); ++i) {
+            std::string name(session->GetInputNameAllocated(i, allocator).get());
+            SessionBinding::Slot slot;
+            if (kind == SessionKind::kEncoder) {
+                if (name == encoderIoConfig_.inputIds) {
+                    slot.role = IoRole::kInputIds;
+                } else if (name == encoderIoConfig_.attentionMask) {
+                    slot.role = IoRole::kAttentionMask;
+                }
+            } else if (kind == SessionKind::kDecoder) {
+                if (name == decoderIoConfig_.inputIds) {
+                    slot.role = IoRole::kInputIds;
+                } else if (name == decoderIoConfig_.encoderAttentionMask) {
+                    slot.role = IoRole::kAttentionMask;
+                } else if (name == decoderIoConfig_.encoderHiddenStates) {
+                    slot.role = IoRole::kEncoderHiddenStates;
+                }
             } else {
-                AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Unknown encoder input: %s", name.c_str());
-                return encoderHiddenStates;
+                if (name == decoderWithPastIoConfig_.inputIds) {
+                    slot.role = IoRole::kInputIds;
+                } else if (name == decoderWithPastIoConfig_.encoderAttentionMask) {
+                    slot.role = IoRole::kAttentionMask;
+                } else if (name == decoderWithPastIoConfig_.encoderHiddenStates) {
+                    slot.role = IoRole::kEncoderHiddenStates;
+                } else if (name == decoderWithPastIoConfig_.useCacheBranch) {
+                    slot.role = IoRole::kUseCacheBranch;
+                } else if ((slot.kvSlot = parseKvSlot(
+                        name, decoderWithPastIoConfig_.pastKeyValuesPrefix)) >= 0 &&
+                           slot.kvSlot < kvSlotCount) {
+                    slot.role = IoRole::kPastKeyValue;
+                }
             }
+
+            if (slot.role == IoRole::kUnused) {
+                AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Unknown %s input: %s", sessionKey, name.c_str());
+                return false;
+            }
+            binding.inputNameStrings.push_back(std::move(name));
+            binding.inputs.push_back(slot);
         }
 
-        auto outputTensors = encoderSession->Run(
-                Ort::RunOptions{ nullptr },
-                inputNames.data(), inputTensors.data(), inputTensors.size(),
-                outputNames.data(), outputNames.size()
-        );
+        // 사용하지 않는 출력은 Run 에 요청하지 않음
+        const std::string& logits = kind == SessionKind::kDecoder
+                                    ? decoderIoConfig_.logits : decoderWithPastIoConfig_.logits;
+        const std::string& presentPrefix = kind == SessionKind::kDecoder
+                                           ? decoderIoConfig_.presentPrefix
+                                           : decoderWithPastIoConfig_.presentPrefix;
+        for (size_t i = 0; i < session->GetOutputCount(); ++i) {
+            std::string name(session->GetOutputNameAllocated(i, allocator).get());
+            SessionBinding::Slot slot;
+            if (kind == SessionKind::kEncoder) {
+                if (name == encoderIoConfig_.lastHiddenState) {
+                    slot.role = IoRole::kLastHiddenState;
+                }
+            } else if (name == logits) {
+                slot.role = IoRole::kLogits;
+            } else if ((slot.kvSlot = parseKvSlot(name, presentPrefix)) >= 0 &&
+                       slot.kvSlot < kvSlotCount) {
+                slot.role = IoRole::kPresentKeyValue;
+            } else if (name.compare(0, presentPrefix.size(), presentPrefix) == 0) {
+                AIDEO_LOGW(LOG_TAG_ENC_DEC_WITH_PAST, "Could not parse KV name: %s", name.c_str());
+            }
 
-        for (size_t i = 0; i < outputTensors.size() && i < outputNames.size(); ++i) {
-            std::string name(outputNames[i]);
-            if (name != encoderIoConfig_.lastHiddenState) {
+            if (slot.role == IoRole::kUnused) {
                 continue;
             }
+            binding.outputNameStrings.push_back(std::move(name));
+            binding.outputs.push_back(slot);
+        }
+    } catch (const Ort::Exception& e) {
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Failed to read %s io names: %s", sessionKey, e.what());
+        return false;
+    }
 
-            if (!outputTensors[i].IsTensor()) {
-                AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
-                           "Encoder output is not tensor: %s", name.c_str());
-                return encoderHiddenStates;
-            }
+    // 문자열 추가가 끝난 뒤에 포인터를 만들어야 재할당으로 무효화되지 않음
+    for (const auto& name: binding.inputNameStrings) {
+        binding.inputNames.push_back(name.c_str());
+    }
+    for (const auto& name: binding.outputNameStrings) {
+        binding.outputNames.push_back(name.c_str());
+    }
+    return true;
+}
 
-            const auto* data = outputTensors[i].GetTensorData<float>();
-            auto tensorInfo = outputTensors[i].GetTensorTypeAndShapeInfo();
-            encoderHiddenStates.assign(data, data + tensorInfo.GetElementCount());
-            return encoderHiddenStates;
+bool EncoderDecoderWithPast::buildSessionBindings() {
+    const bool merged = useMergedDecoder_.load();
+    if (!buildSessionBinding(kEncoderSessionKey, SessionKind::kEncoder, encoderBinding_) ||
+        !buildSessionBinding(firstStepSessionKey(),
+                             merged ? SessionKind::kDecoderWithPast : SessionKind::kDecoder,
+                             firstStepBinding_) ||
+        !buildSessionBinding(cachedStepSessionKey(), SessionKind::kDecoderWithPast,
+                             cachedStepBinding_)) {
+        return false;
+    }
+
+    // 첫 step 의 present 가 모든 KV 슬롯을, cached step 의 present 가 모든 decoder 슬롯을 채워야
+    // cached step 의 past 입력이 매 step 올바르게 이어짐 → 요청마다가 아니라 load 시 한 번 확인
+    const int kvSlotCount = dimensions_.numDecoderLayers * 4;
+    std::vector<bool> firstStepPresents(static_cast<size_t>(kvSlotCount), false);
+    std::vector<bool> cachedStepPresents(static_cast<size_t>(kvSlotCount), false);
+    std::vector<bool> cachedStepPasts(static_cast<size_t>(kvSlotCount), false);
+    for (const auto& slot: firstStepBinding_.outputs) {
+        if (slot.role == IoRole::kPresentKeyValue) {
+            firstStepPresents[static_cast<size_t>(slot.kvSlot)] = true;
+        }
+    }
+    for (const auto& slot: cachedStepBinding_.outputs) {
+        if (slot.role == IoRole::kPresentKeyValue) {
+            cachedStepPresents[static_cast<size_t>(slot.kvSlot)] = true;
         }
+    }
+    for (const auto& slot: cachedStepBinding_.inputs) {
+        if (slot.role == IoRole::kPastKeyValue) {
+            cachedStepPasts[static_cast<size_t>(slot.kvSlot)] = true;
+        }
+    }
 
-        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Missing encoder output: %s",
-                   encoderIoConfig_.lastHiddenState.c_str());
-    } catch (const Ort::Exception& e) {
-        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Encoder inference failed: %s", e.what());
+    int missingSlots = 0;
+    for (int kvSlot = 0; kvSlot < kvSlotCount; ++kvSlot) {
+        const auto index = static_cast<size_t>(kvSlot);
+        const bool decoderSlot = kvSlot % 4 < 2;
+        if (!firstStepPresents[index] || !cachedStepPasts[index] ||
+            (decoderSlot && !cachedStepPresents[index])) {
+            ++missingSlots;
+        }
     }
-    return encoderHiddenStates;
+    if (missingSlots > 0) {
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "%d of %d KV cache slots are not produced or consumed",
+                   missingSlots, kvSlotCount);
+        return false;
+    }
+    return true;
 }
 
-EncoderDecoderWithPast::DecoderOutput EncoderDecoderWithPast::runDecoder(
+bool EncoderDecoderWithPast::runEncoder(
+        const Ort::RunOptions& runOptions,
+        BumpArenaAllocator& arena,
         const std::vector<int64_t>& inputIds,
-        const std::vector<int64_t>& encoderAttentionMask,
-        const std::vector<float>& encoderHiddenStates,
-        int64_t batchSize,
-        int64_t decoderSeqLength,
-        int64_t encoderSeqLength) {
+        const std::vector<int64_t>& attentionMask,
+        GenerationState& state
+) {
 
-    DecoderOutput output;
-    auto* decoderSession = inference_.getSession(kDecoderSessionKey, "Decoder");
-    if (!decoderSession) {
-        return output;
+    auto encoderSession = inference_.getSession(kEncoderSessionKey, "Encoder");
+    if (!encoderSession) {
+        return false;
     }
-
-    Ort::AllocatorWithDefaultOptions allocator;
+    const auto& binding = encoderBinding_;
 
     try {
-        auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
-        std::vector<Ort::AllocatedStringPtr> inputNamePtrs;
-        std::vector<const char*> inputNames;
-        for (size_t i = 0; i < decoderSession->GetInputCount(); ++i) {
-            inputNamePtrs.push_back(decoderSession->GetInputNameAllocated(i, allocator));
-            inputNames.push_back(inputNamePtrs.back().get());
-        }
-
-        std::vector<int64_t> inputIdsShape = { batchSize, decoderSeqLength };
-        std::vector<int64_t> attentionMaskShape = { batchSize, encoderSeqLength };
-        std::vector<int64_t> encoderHiddenShape = {
-                batchSize, encoderSeqLength, static_cast<int64_t>(hiddenSize_) };
-
-        std::vector<Ort::Value> inputTensors;
-        for (auto& inputName: inputNames) {
-            std::string name(inputName);
-            if (name == decoderIoConfig_.inputIds) {
-                inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
-                        memoryInfo,
-                        const_cast<int64_t*>(inputIds.data()), inputIds.size(),
-                        inputIdsShape.data(), inputIdsShape.size()
-                ));
-            } else if (name == decoderIoConfig_.encoderAttentionMask) {
-                inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
-                        memoryInfo,
-                        const_cast<int64_t*>(encoderAttentionMask.data()),
-                        encoderAttentionMask.size(),
-                        attentionMaskShape.data(), attentionMaskShape.size()
-                ));
-            } else if (name == decoderIoConfig_.encoderHiddenStates) {
-                inputTensors.push_back(Ort::Value::CreateTensor<float>(
-                        memoryInfo,
-                        const_cast<float*>(encoderHiddenStates.data()), encoderHiddenStates.size(),
-                        encoderHiddenShape.data(), encoderHiddenShape.size()
-                ));
-            } else {
-                AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Unknown decoder input: %s", name.c_str());
-                return output;
-            }
-        }
+        const Ort::MemoryInfo& memoryInfo = arena.memoryInfo();
+        const auto seqLength = static_cast<int64_t>(inputIds.size());
+        const int64_t inputShape[] = { 1, seqLength };
+
+        // mask 는 이후 모든 decoder step 에도 그대로 바인딩
+        state.encoderSeqLength = seqLength;
+        state.attentionMask = Ort::Value::CreateTensor<int64_t>(
+                memoryInfo,
+                const_cast<int64_t*>(attentionMask.data()), attentionMask.size(),
+                inputShape, 2
+        );
+        Ort::Value inputIdsTensor = Ort::Value::CreateTensor<int64_t>(
+                memoryInfo,
+                const_cast<int64_t*>(inputIds.data()), inputIds.size(),
+                inputShape, 2
+        );
 
-        std::vector<Ort::AllocatedStringPtr> outputNamePtrs;
-        std::vector<const char*> outputNames;
-        for (size_t i = 0; i < decoderSession->GetOutputCount(); ++i) {
-            outputNamePtrs.push_back(decoderSession->GetOutputNameAllocated(i, allocator));
-            outputNames.push_back(outputNamePtrs.back().get());
+        // 입력 순서와 역할은 load 시 encoderBinding_ 에 확정됨 (input_ids / attention_mask 뿐)
+        // 통계용 크기는 shape 으로 계산 (Run 마다 텐서 shape 정보를 조회하지 않음)
+        Ort::IoBinding ioBinding(*encoderSession);
+        int64_t inputBytes = 0;
+        for (size_t i = 0; i < binding.inputs.size(); ++i) {
+            ioBinding.BindInput(binding.inputNames[i],
+                                binding.inputs[i].role == IoRole::kInputIds ? inputIdsTensor : state.attentionMask);
+            inputBytes += seqLength * static_cast<int64_t>(sizeof(int64_t));
         }
 
-        auto outputTensors = decoderSession->Run(
-                Ort::RunOptions{ nullptr },
-                inputNames.data(), inputTensors.data(), inputTensors.size(),
-                outputNames.data(), outputNames.size()
-        );
-
-        bool hasLogits = false;
-        for (size_t i = 0; i < outputTensors.size() && i < outputNames.size(); ++i) {
-            std::string name(outputNames[i]);
-            if (name == decoderIoConfig_.logits) {
-                if (!outputTensors[i].IsTensor()) {
-                    AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
-                               "Decoder output is not tensor: %s", name.c_str());
-                    return output;
-                }
+        // hidden states 는 decoder step 마다 바인딩되므로 Checkpoint 없이 arena 에 할당해 요청 끝까지 유지
+        Ort::Value hiddenStates = arenaOutputTensor(
+                arena, { 1, seqLength, static_cast<int64_t>(dimensions_.hiddenSize) });
+        int64_t outputBytes = 0;
+        for (size_t i = 0; i < binding.outputs.size(); ++i) {
+            bindOutput(ioBinding, binding.outputNames[i], hiddenStates, memoryInfo);
+            outputBytes += seqLength * dimensions_.hiddenSize * static_cast<int64_t>(sizeof(float));
+        }
 
-                const auto* logitsData = outputTensors[i].GetTensorData<float>();
-                auto tensorInfo = outputTensors[i].GetTensorTypeAndShapeInfo();
-                output.logits.assign(logitsData, logitsData + tensorInfo.GetElementCount());
-                hasLogits = true;
-            } else if (name.compare(
-                    0, decoderIoConfig_.presentPrefix.size(), decoderIoConfig_.presentPrefix) ==
-                       0) {
-                if (!outputTensors[i].IsTensor()) {
-                    AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
-                               "Decoder KV output is not tensor: %s", name.c_str());
-                    continue;
-                }
+        inference_.run(kEncoderSessionKey, encoderSession, runOptions, ioBinding, inputBytes, outputBytes);
+        // 요청마다 한 번이므로 바인딩 순서의 출력을 그대로 꺼내 확인 (arena 에 출력했으면 같은 버퍼를 가리킴)
+        auto outputs = ioBinding.GetOutputValues();
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            if (binding.outputs[i].role != IoRole::kLastHiddenState) {
+                continue;
+            }
 
-                const auto* data = outputTensors[i].GetTensorData<float>();
-                auto tensorInfo = outputTensors[i].GetTensorTypeAndShapeInfo();
-                output.presentKeyValues.emplace_back(data, data + tensorInfo.GetElementCount());
-                output.presentKeyValueShapes.push_back(tensorInfo.GetShape());
-                output.kvOutputNames.push_back(name);
+            if (!outputs[i].IsTensor()) {
+                AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
+                           "Encoder output is not tensor: %s", binding.outputNames[i]);
+                return false;
             }
+            state.encoderHiddenStates = std::move(outputs[i]);
+            return true;
         }
 
-        if (!hasLogits) {
-            AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Missing decoder output: %s",
-                       decoderIoConfig_.logits.c_str());
-        }
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Missing encoder output: %s",
+                   encoderIoConfig_.lastHiddenState.c_str());
     } catch (const Ort::Exception& e) {
-        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Decoder inference failed: %s", e.what());
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Encoder inference failed: %s", e.what());
     }
-    return output;
+    return false;
 }
 
-EncoderDecoderWithPast::DecoderOutput EncoderDecoderWithPast::runDecoderWithPast(
-        const std::vector<int64_t>& decoderInputIds,
-        const std::vector<int64_t>& encoderAttentionMask,
-        const std::vector<float>& encoderHiddenStates,
-        const std::vector<std::vector<float>>& pastKeyValues,
-        const std::vector<std::vector<int64_t>>& pastKeyValueShapes,
-        int64_t batchSize,
-        int64_t encoderSeqLength
+bool EncoderDecoderWithPast::runDecoderStep(
+        const Ort::RunOptions& runOptions,
+        BumpArenaAllocator& arena,
+        const char* sessionKey,
+        const SessionBinding& binding,
+        const std::vector<int64_t>& inputIds,
+        bool useCacheBranch,
+        int64_t fallbackTokenId,
+        GenerationState& state,
+        int64_t& nextToken
 ) {
 
-    DecoderOutput output;
-    auto* decoderWithPastSession = inference_.getSession(
-            kDecoderWithPastSessionKey, "Decoder with past");
-    if (!decoderWithPastSession) {
-        return output;
+    auto session = inference_.getSession(sessionKey, sessionKey);
+    if (!session) {
+        return false;
     }
 
-    Ort::AllocatorWithDefaultOptions allocator;
-
     try {
-        auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
-        std::vector<Ort::AllocatedStringPtr> modelInputNamePtrs;
-        std::vector<std::string> modelInputNames;
-        for (size_t i = 0; i < decoderWithPastSession->GetInputCount(); ++i) {
-            modelInputNamePtrs.push_back(
-                    decoderWithPastSession->GetInputNameAllocated(i, allocator));
-            modelInputNames.emplace_back(modelInputNamePtrs.back().get());
-        }
-
-        std::vector<int64_t> inputIdsShape = { batchSize, 1 };
-        std::vector<int64_t> encoderAttentionMaskShape = { batchSize, encoderSeqLength };
-        std::vector<int64_t> encoderHiddenShape = { batchSize, encoderSeqLength,
-                                                    static_cast<int64_t>(hiddenSize_) };
-
-        const size_t requiredKvCacheCount = static_cast<size_t>(numDecoderLayers_) * 4;
-        if (pastKeyValues.size() < requiredKvCacheCount ||
-            pastKeyValueShapes.size() < requiredKvCacheCount) {
-            AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "KV cache index out of bounds");
-            return output;
-        }
-
-        std::vector<Ort::Value> inputTensors;
-        std::vector<const char*> inputNames;
-        for (const auto& name: modelInputNames) {
-            if (name == decoderWithPastIoConfig_.inputIds) {
-                inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
-                        memoryInfo,
-                        const_cast<int64_t*>(decoderInputIds.data()), decoderInputIds.size(),
-                        inputIdsShape.data(), inputIdsShape.size()
-                ));
-                inputNames.push_back(name.c_str());
-            } else if (name == decoderWithPastIoConfig_.encoderAttentionMask) {
-                inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
-                        memoryInfo,
-                        const_cast<int64_t*>(encoderAttentionMask.data()),
-                        encoderAttentionMask.size(),
-                        encoderAttentionMaskShape.data(), encoderAttentionMaskShape.size()
-                ));
-                inputNames.push_back(name.c_str());
-            } else if (name == decoderWithPastIoConfig_.encoderHiddenStates) {
-                inputTensors.push_back(Ort::Value::CreateTensor<float>(
-                        memoryInfo,
-                        const_cast<float*>(encoderHiddenStates.data()), encoderHiddenStates.size(),
-                        encoderHiddenShape.data(), encoderHiddenShape.size()
-                ));
-                inputNames.push_back(name.c_str());
-            } else {
-                bool matchedPastKeyValue = false;
-                for (int i = 0; i < numDecoderLayers_ && !matchedPastKeyValue; ++i) {
-                    const size_t baseIdx = static_cast<size_t>(i) * 4;
-                    const std::string pastLayerPrefix =
-                            decoderWithPastIoConfig_.pastKeyValuesPrefix + std::to_string(i) + ".";
-
-                    int valueOffset = -1;
-                    if (name == pastLayerPrefix + decoderWithPastIoConfig_.decoderKey) {
-                        valueOffset = 0;
-                    } else if (name == pastLayerPrefix + decoderWithPastIoConfig_.decoderValue) {
-                        valueOffset = 1;
-                    } else if (name == pastLayerPrefix + decoderWithPastIoConfig_.encoderKey) {
-                        valueOffset = 2;
-                    } else if (name == pastLayerPrefix + decoderWithPastIoConfig_.encoderValue) {
-                        valueOffset = 3;
-                    }
+        // ORT 가 직접 할당하는 출력(arena / kvCache 확보 실패 시)에만 쓰이므로 arena 의 CPU memory info 를 그대로 사용
+        const Ort::MemoryInfo& memoryInfo = arena.memoryInfo();
+
+        // 세션이 바뀔 때만 IoBinding 을 새로 만들고, binding 이 바뀔 때만 이전 바인딩을 지움
+        // 같은 binding 이면 모든 이름을 다시 바인딩하므로 ORT 가 이름별 값을 제자리에서 교체
+        if (state.boundSession.get() != session.get()) {
+            state.ioBinding = Ort::IoBinding(*session);
+            state.boundSession = session;
+            state.boundBinding = nullptr;
+        }
+        auto& ioBinding = state.ioBinding;
+        if (state.boundBinding != &binding) {
+            ioBinding.ClearBoundInputs();
+            ioBinding.ClearBoundOutputs();
+            state.boundBinding = &binding;
+        }
 
-                    if (valueOffset < 0) {
-                        continue;
+        // cached step 은 1 토큰 → state 의 텐서에 값만 바꿔 바인딩, 첫 step 은 초기 decoder 입력 전체
+        const auto inputLength = static_cast<int64_t>(inputIds.size());
+        Ort::Value firstStepInputIds{ nullptr };
+        const Ort::Value* inputIdsTensor = &state.stepInputIds;
+        if (useCacheBranch && inputLength == 1) {
+            if (!state.stepInputIds) {
+                const int64_t shape[] = { 1, 1 };
+                state.stepInputIds = Ort::Value::CreateTensor<int64_t>(
+                        memoryInfo, &state.stepInputId, 1, shape, 2);
+            }
+            state.stepInputId = inputIds[0];
+        } else {
+            const int64_t shape[] = { 1, inputLength };
+            firstStepInputIds = Ort::Value::CreateTensor<int64_t>(
+                    memoryInfo, const_cast<int64_t*>(inputIds.data()), inputIds.size(), shape, 2);
+            inputIdsTensor = &firstStepInputIds;
+        }
+        if (!state.useCacheBranchTensor) {
+            const int64_t shape[] = { 1 };
+            state.useCacheBranchTensor = Ort::Value::CreateTensor<bool>(
+                    memoryInfo, &state.useCacheBranch, 1, shape, 1);
+        }
+        state.useCacheBranch = useCacheBranch;
+
+        // past_key_values 입력은 load 시 확정된 KV 슬롯의 이전 present 를 그대로 바인딩
+        // 통계용 크기는 바인딩한 shape 으로 계산 (Run 마다 텐서 shape 정보를 조회하지 않음)
+        // KV 위치 하나 = [heads][headDim] float. 첫 step 의 past 는 merged decoder 의 길이 1 dummy
+        const int64_t kvPositionBytes =
+                static_cast<int64_t>(dimensions_.numHeads) * dimensions_.headDim * static_cast<int64_t>(sizeof(float));
+        int64_t inputBytes = 0;
+        for (size_t i = 0; i < binding.inputs.size(); ++i) {
+            const auto& input = binding.inputs[i];
+            const char* name = binding.inputNames[i];
+            switch (input.role) {
+                case IoRole::kInputIds:
+                    ioBinding.BindInput(name, *inputIdsTensor);
+                    inputBytes += inputLength * static_cast<int64_t>(sizeof(int64_t));
+                    break;
+                case IoRole::kAttentionMask:
+                    ioBinding.BindInput(name, state.attentionMask);
+                    inputBytes += state.encoderSeqLength * static_cast<int64_t>(sizeof(int64_t));
+                    break;
+                case IoRole::kEncoderHiddenStates:
+                    ioBinding.BindInput(name, state.encoderHiddenStates);
+                    inputBytes += state.encoderSeqLength * dimensions_.hiddenSize * static_cast<int64_t>(sizeof(float));
+                    break;
+                case IoRole::kUseCacheBranch:
+                    ioBinding.BindInput(name, state.useCacheBranchTensor);
+                    inputBytes += static_cast<int64_t>(sizeof(bool));
+                    break;
+                case IoRole::kPastKeyValue: {
+                    const auto& past = state.pastKeyValues[static_cast<size_t>(input.kvSlot)];
+                    if (!past) {
+                        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Missing past key value: %s", name);
+                        return false;
                     }
-
-                    const size_t pastIdx = baseIdx + static_cast<size_t>(valueOffset);
-                    inputTensors.push_back(Ort::Value::CreateTensor<float>(
-                            memoryInfo,
-                            const_cast<float*>(pastKeyValues[pastIdx].data()),
-                            pastKeyValues[pastIdx].size(),
-                            pastKeyValueShapes[pastIdx].data(),
-                            pastKeyValueShapes[pastIdx].size()
-                    ));
-                    inputNames.push_back(name.c_str());
-                    matchedPastKeyValue = true;
+                    ioBinding.BindInput(name, past);
+                    const int64_t pastLength = !useCacheBranch ? 1
+                                               : input.kvSlot % 4 < 2 ? state.pastLength
+                                               : state.encoderSeqLength;
+                    inputBytes += pastLength * kvPositionBytes;
+                    break;
                 }
+                default:
+                    // buildSessionBinding() 에서 걸러지므로 도달하지 않음
+                    AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Unexpected %s input role", sessionKey);
+                    return false;
+            }
+        }
 
-                if (!matchedPastKeyValue) {
-                    AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Unknown decoder with past input: %s",
-                               name.c_str());
-                    return output;
-                }
+        // 출력은 모두 미리 할당한 버퍼에 바인딩하고 Run 후에도 같은 Value 를 읽음 (GetOutputValues 로 다시 꺼내지 않음)
+        // - logits [1, inputLength, vocab] : 첫 step 에서 arena 에 할당해 요청 끝까지 유지. cached step 의
+        //   logits [1, 1, vocab] 는 같은 버퍼의 앞부분 → 첫 step 이후 arena 를 더 쓰지 않음
+        // - cross-attention K/V 는 encoder 출력에만 의존 → 첫 step 에서 arena 에 고정하고, 이후 step 은 past 로
+        //   바인딩만 함. cached step 의 encoder present(merged decoder 가 다시 내보냄)는 받지 않음
+        // - decoder present [1, heads, past + input, headDim] 는 kvCache 의 반대쪽 절반에 출력 → 다음 step 의 past 로 그대로 바인딩
+        // 확보하지 못한 출력은 null 로 바인딩 → ORT 가 할당하고, 그런 step 에서만 GetOutputValues 로 꺼냄
+        Ort::Value firstStepLogits{ nullptr };
+        if (!useCacheBranch && inputLength > 0 && dimensions_.vocabSize > 0) {
+            const size_t logitsCount = static_cast<size_t>(inputLength) * static_cast<size_t>(dimensions_.vocabSize);
+            auto* logitsData = static_cast<float*>(arena.allocate(logitsCount * sizeof(float)));
+            if (logitsData != nullptr) {
+                const int64_t firstStepShape[] = { 1, inputLength, dimensions_.vocabSize };
+                firstStepLogits = Ort::Value::CreateTensor<float>(
+                        memoryInfo, logitsData, logitsCount, firstStepShape, 3);
+                const int64_t stepShape[] = { 1, 1, dimensions_.vocabSize };
+                state.stepLogits = Ort::Value::CreateTensor<float>(
+                        memoryInfo, logitsData, static_cast<size_t>(dimensions_.vocabSize), stepShape, 3);
             }
         }
+        Ort::Value& logitsTensor = useCacheBranch ? state.stepLogits : firstStepLogits;
 
-        // 출력 이름: 동적으로 모델에서 가져옴
-        std::vector<Ort::AllocatedStringPtr> outputNamePtrs;
-        std::vector<const char*> outputNames;
-        for (size_t i = 0; i < decoderWithPastSession->GetOutputCount(); ++i) {
-            outputNamePtrs.push_back(decoderWithPastSession->GetOutputNameAllocated(i, allocator));
-            outputNames.push_back(outputNamePtrs.back().get());
+        while (state.presentOutputs.size() < binding.outputs.size()) {
+            state.presentOutputs.emplace_back(nullptr);
+        }
+        const int64_t presentLength = (useCacheBranch ? state.pastLength : 0) + inputLength;
+        const int presentHalf = 1 - state.kvHalf;
+        state.boundOutputs.clear();
+        bool ortAllocatesOutputs = false;
+        int64_t outputBytes = 0;
+        for (size_t i = 0; i < binding.outputs.size(); ++i) {
+            const auto& slot = binding.outputs[i];
+            const char* name = binding.outputNames[i];
+            auto& present = state.presentOutputs[i];
+            if (slot.role == IoRole::kLogits) {
+                bindOutput(ioBinding, name, logitsTensor, memoryInfo);
+                ortAllocatesOutputs = ortAllocatesOutputs || !logitsTensor;
+                outputBytes += inputLength * dimensions_.vocabSize * static_cast<int64_t>(sizeof(float));
+            } else if (slot.kvSlot % 4 < 2) {
+                // 용량을 넘으면 null view → ORT 가 할당
+                const int decoderSlot = slot.kvSlot / 4 * 2 + slot.kvSlot % 4;
+                present = state.kvCache != nullptr
+                          ? state.kvCache->view(decoderSlot, presentHalf, presentLength)
+                          : Ort::Value{ nullptr };
+                bindOutput(ioBinding, name, present, memoryInfo);
+                ortAllocatesOutputs = ortAllocatesOutputs || !present;
+                outputBytes += presentLength * kvPositionBytes;
+            } else if (!useCacheBranch) {
+                present = arenaOutputTensor(
+                        arena, { 1, dimensions_.numHeads, state.encoderSeqLength, dimensions_.headDim });
+                bindOutput(ioBinding, name, present, memoryInfo);
+                ortAllocatesOutputs = ortAllocatesOutputs || !present;
+                outputBytes += state.encoderSeqLength * kvPositionBytes;
+            } else {
+                continue;
+            }
+            state.boundOutputs.push_back(i);
         }
 
-        auto outputTensors = decoderWithPastSession->Run(
-                Ort::RunOptions{ nullptr },
-                inputNames.data(), inputTensors.data(), inputTensors.size(),
-                outputNames.data(), outputNames.size()
-        );
+        inference_.run(sessionKey, session, runOptions, ioBinding, inputBytes, outputBytes);
+        std::vector<Ort::Value> ortOutputs;
+        if (ortAllocatesOutputs) {
+            ortOutputs = ioBinding.GetOutputValues();
+        }
 
         bool hasLogits = false;
-        for (size_t i = 0; i < outputTensors.size() && i < outputNames.size(); ++i) {
-            std::string name(outputNames[i]);
-            if (name == decoderWithPastIoConfig_.logits) {
-                if (!outputTensors[i].IsTensor()) {
+        for (size_t i = 0; i < state.boundOutputs.size(); ++i) {
+            const size_t outputIndex = state.boundOutputs[i];
+            const auto& slot = binding.outputs[outputIndex];
+            Ort::Value* output = slot.role == IoRole::kLogits ? &logitsTensor : &state.presentOutputs[outputIndex];
+            const bool ortAllocated = !*output;
+            if (ortAllocated) {
+                if (i >= ortOutputs.size()) {
                     AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
-                               "Decoder with past output is not tensor: %s", name.c_str());
-                    return output;
+                               "Missing %s output: %s", sessionKey, binding.outputNames[outputIndex]);
+                    return false;
                 }
+                output = &ortOutputs[i];
+            }
+            if (!output->IsTensor()) {
+                AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
+                           "%s output is not tensor: %s", sessionKey, binding.outputNames[outputIndex]);
+                return false;
+            }
 
-                const auto* logitsData = outputTensors[i].GetTensorData<float>();
-                auto tensorInfo = outputTensors[i].GetTensorTypeAndShapeInfo();
-                output.logits.assign(logitsData, logitsData + tensorInfo.GetElementCount());
-                hasLogits = true;
-            } else if (name.compare(0,
-                                    decoderWithPastIoConfig_.presentPrefix.size(),
-                                    decoderWithPastIoConfig_.presentPrefix) == 0) {
-                if (!outputTensors[i].IsTensor()) {
-                    AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
-                               "Decoder with past KV output is not tensor: %s", name.c_str());
-                    continue;
+            if (slot.role == IoRole::kLogits) {
+                // 미리 할당한 버퍼는 shape 이 [1, inputLength, vocab] 으로 고정 (다르면 Run 이 실패함)
+                // ORT 가 할당한 경우에만 shape 을 조회하며, ortOutputs 가 살아 있는 동안 유효
+                int64_t rows = inputLength;
+                if (ortAllocated) {
+                    const auto elementCount = static_cast<int64_t>(
+                            output->GetTensorTypeAndShapeInfo().GetElementCount());
+                    if (dimensions_.vocabSize <= 0 || elementCount % dimensions_.vocabSize != 0) {
+                        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
+                                   "Logits size is not divisible by vocab size: %lld %% %lld",
+                                   static_cast<long long>(elementCount),
+                                   static_cast<long long>(dimensions_.vocabSize));
+                        return false;
+                    }
+                    rows = elementCount / dimensions_.vocabSize;
                 }
-
-                const auto* data = outputTensors[i].GetTensorData<float>();
-                auto tensorInfo = outputTensors[i].GetTensorTypeAndShapeInfo();
-                output.presentKeyValues.emplace_back(data, data + tensorInfo.GetElementCount());
-                output.presentKeyValueShapes.push_back(tensorInfo.GetShape());
-                output.kvOutputNames.push_back(name);
+                LogitsView logits;
+                logits.data = output->GetTensorData<float>();
+                logits.rows = rows;
+                logits.vocabSize = dimensions_.vocabSize;
+                nextToken = tokenSelector_->select(logits, fallbackTokenId);
+                hasLogits = true;
+            } else {
+                state.pastKeyValues[static_cast<size_t>(slot.kvSlot)] = std::move(*output);
             }
         }
 
         if (!hasLogits) {
-            AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Missing decoder with past output: %s",
+            AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Missing %s output: %s", sessionKey,
                        decoderWithPastIoConfig_.logits.c_str());
+            return false;
         }
+        state.kvHalf = presentHalf;
+        state.pastLength = presentLength;
+        return true;
 
     } catch (const Ort::Exception& e) {
-        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Decoder with past inference failed: %s", e.what());
+        AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "%s inference failed: %s", sessionKey, e.what());
     }
-    return output;
+    return false;
 }
 
 std::vector<int64_t> EncoderDecoderWithPast::generateSingle(
@@ -472,19 +1108,44 @@ std::vector<int64_t> EncoderDecoderWithPast::generateSingle(
         const std::vector<int64_t>& encoderAttentionMask,
         const std::vector<int64_t>& initialDecoderInputIds,
         int64_t eosTokenId,
-        int maxLength
+        int maxLength,
+        const CancellationToken* cancellation
 ) {
 
     std::vector<int64_t> generatedTokens;
     if (!inference_.hasSession(kEncoderSessionKey) ||
-        !inference_.hasSession(kDecoderSessionKey) ||
-        !inference_.hasSession(kDecoderWithPastSessionKey)) {
+        !inference_.hasSession(firstStepSessionKey()) ||
+        !inference_.hasSession(cachedStepSessionKey())) {
         AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Encoder-decoder sessions not loaded");
         return generatedTokens;
     }
 
+    // 출력 텐서용 arena — 요청이 끝나면 reset 후 풀에 반납
+    struct ArenaLease {
+        EncoderDecoderWithPast& owner;
+        std::unique_ptr<BumpArenaAllocator> arena;
+
+        ~ArenaLease() { owner.releaseArena(std::move(arena)); }
+    } arenaLease{ *this, acquireArena() };
+    BumpArenaAllocator& arena = *arenaLease.arena;
+
+    // decoder KV 버퍼 — 요청이 끝나면 용량을 유지한 채 풀에 반납
+    struct KvCacheLease {
+        EncoderDecoderWithPast& owner;
+        std::unique_ptr<KvCacheBuffers> kvCache;
+
+        ~KvCacheLease() { owner.releaseKvCache(std::move(kvCache)); }
+    } kvCacheLease{ *this, acquireKvCache() };
+
+    // 취소 핸들이 없으면 기본 RunOptions (terminate 되지 않음)
+    Ort::RunOptions defaultRunOptions{ nullptr };
+    const Ort::RunOptions& runOptions =
+            cancellation != nullptr ? cancellation->runOptions() : defaultRunOptions;
+    auto isCancelled = [cancellation]() {
+        return cancellation != nullptr && cancellation->isCancelled();
+    };
+
     try {
-        auto encoderSeqLen = static_cast<int64_t>(encoderInputIds.size());
         if (encoderInputIds.size() != encoderAttentionMask.size()) {
             AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
                        "Encoder input ids and attention mask size mismatch: %zu != %zu",
@@ -492,132 +1153,95 @@ std::vector<int64_t> EncoderDecoderWithPast::generateSingle(
             return generatedTokens;
         }
 
+        // encoder 출력, mask, KV cache 는 Ort::Value 로 유지되어 step 사이에 복사되지 않음
+        GenerationState state;
+        const auto kvSlotCount = static_cast<size_t>(dimensions_.numDecoderLayers) * 4;
+        state.pastKeyValues.reserve(kvSlotCount);
+        for (size_t i = 0; i < kvSlotCount; ++i) {
+            state.pastKeyValues.emplace_back(nullptr);
+        }
+
+        // present 최대 길이 = 초기 decoder 입력 + cached step 수 → 요청 시작 시 한 번만 확보하고 step 중에는 할당 없음
+        const auto kvCapacity = static_cast<int64_t>(initialDecoderInputIds.size()) + std::max(0, maxLength - 1);
+        if (kvCacheLease.kvCache->reserve(
+                dimensions_.numDecoderLayers * 2, dimensions_.numHeads, dimensions_.headDim, kvCapacity)) {
+            state.kvCache = kvCacheLease.kvCache.get();
+        } else {
+            AIDEO_LOGW(LOG_TAG_ENC_DEC_WITH_PAST, "KV cache buffers unavailable; ORT allocates each step");
+        }
+
         // 단계 2: Encoder 실행
-        auto encoderHiddenStates = runEncoder(encoderInputIds, encoderAttentionMask, 1,
-                                              encoderSeqLen);
-        if (encoderHiddenStates.empty()) {
+        bool encoded = runEncoder(runOptions, arena, encoderInputIds, encoderAttentionMask, state);
+        if (isCancelled()) {
+            AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "Generation cancelled after encoder");
+            return {};
+        }
+        if (!encoded) {
             AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Encoder returned empty output");
             return generatedTokens;
         }
 
         // 단계 4: 첫 번째 Decoder 실행 (KV 캐시 초기화)
-        auto decoderOutput = runDecoder(
-                initialDecoderInputIds,
-                encoderAttentionMask,
-                encoderHiddenStates,
-                1,
-                static_cast<int64_t>(initialDecoderInputIds.size()),
-                encoderSeqLen);
-        if (decoderOutput.logits.empty()) {
+        // merged decoder 는 use_cache_branch = false 분기 → 분리형 decoder 와 같은 출력
+        if (useMergedDecoder_.load() && !bindDummyPastKeyValues(arena, state)) {
+            return generatedTokens;
+        }
+        int64_t nextToken = eosTokenId;
+        bool decoded = runDecoderStep(
+                runOptions, arena, firstStepSessionKey(), firstStepBinding_,
+                initialDecoderInputIds, false, eosTokenId, state, nextToken);
+        if (isCancelled()) {
+            AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "Generation cancelled after decoder");
+            return {};
+        }
+        if (!decoded) {
             AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "Decoder returned empty logits");
             return generatedTokens;
         }
 
-        // 단계 5: 다음 토큰 선택
-        int64_t nextToken = tokenSelector_->select(decoderOutput.logits, vocabSize_, eosTokenId);
+        // 단계 5: 다음 토큰 선택 (runDecoderStep 에서 logits 출력 버퍼를 그대로 읽어 선택됨)
         generatedTokens.push_back(nextToken);
 
         // 단계 6: Autoregressive generation with KV cache
-        //TODO: onnxruntime_inference.cpp 내부에서 kvCache 에 대해 범용으로 사용하기 위해, 각 모델의 export 사항 별 달라지는 kvCache 규격을 normalization 한 것으로 보임
-        //TODO: normalization 과정을 결과적으로 성능 오버헤드를 야기하니까, 이 부분을 사용하지 않는 선에서의 개선된 코드가 필요함.
-        std::vector<std::vector<float>> allKVCache;
-        std::vector<std::vector<int64_t>> allKVShapes;
-        allKVCache.resize(numDecoderLayers_ * 4);
-        allKVShapes.resize(numDecoderLayers_ * 4);
-
-        if (decoderOutput.kvOutputNames.size() == decoderOutput.presentKeyValues.size()) {
-            for (size_t i = 0; i < decoderOutput.presentKeyValues.size(); ++i) {
-                auto [layerIdx, typeOffset] = parseKvOutputName(decoderOutput.kvOutputNames[i]);
-                if (layerIdx >= 0 && layerIdx < numDecoderLayers_ && typeOffset >= 0) {
-                    int targetIdx = layerIdx * 4 + typeOffset;
-                    allKVCache[targetIdx] = std::move(decoderOutput.presentKeyValues[i]);
-                    allKVShapes[targetIdx] = std::move(decoderOutput.presentKeyValueShapes[i]);
-                } else {
-                    AIDEO_LOGW(LOG_TAG_ENC_DEC_WITH_PAST, "Could not parse KV name: %s",
-                               decoderOutput.kvOutputNames[i].c_str());
-                }
-            }
-
-            //TODO allKVCache 로의 이동이 필요할까? 그냥 바로 decoderOutput 을 이용할 수는 없을까? 만약, 이 로직이 틀리면 emptySlot 발생 -> decoderWithPast 동작의 정확도가 보장이 안된다.
-            int emptySlots = 0;
-            for (int i = 0; i < numDecoderLayers_ * 4; ++i) {
-                if (allKVCache[i].empty()) {
-                    emptySlots++;
-                }
-            }
-            if (emptySlots > 0) {
-                AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
-                           "WARNING: %d KV cache slots are empty after initial setup!", emptySlots);
-            }
-        } else {
-            for (size_t i = 0; i < decoderOutput.presentKeyValues.size(); ++i) {
-                allKVCache[i] = std::move(decoderOutput.presentKeyValues[i]);
-                allKVShapes[i] = std::move(decoderOutput.presentKeyValueShapes[i]);
-            }
-        }
-
         std::vector<int64_t> nextInputIds(1);
 
         for (int step = 0; step < maxLength - 1; ++step) {
             if (nextToken == eosTokenId) {
                 break;
             }
+            // 취소는 최대 1 step 안에 반영됨 (진행 중인 Run 은 terminate flag 로 중단)
+            if (isCancelled()) {
+                AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "Generation cancelled at step %d", step);
+                return {};
+            }
 
             nextInputIds[0] = nextToken;
 
-            auto nextOutput = runDecoderWithPast(
-                    nextInputIds,
-                    encoderAttentionMask,
-                    encoderHiddenStates,
-                    allKVCache,
-                    allKVShapes,
-                    1, // batch_size
-                    encoderSeqLen
-            );
-
-            if (nextOutput.logits.empty()) {
+            int threadLevel = -1;
+            const char* stepSessionKey = activeCachedStepSessionKey(threadLevel);
+            auto stepStartedAt = std::chrono::steady_clock::now();
+            bool stepped = runDecoderStep(
+                    runOptions, arena, stepSessionKey, cachedStepBinding_, nextInputIds, true,
+                    eosTokenId, state, nextToken);
+            // 실패/취소된 step 의 시간은 단계 평가에서 제외
+            if (threadLevel >= 0 && stepped) {
+                threadController_->recordStep(
+                        threadLevel,
+                        std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - stepStartedAt).count());
+            }
+
+            if (isCancelled()) {
+                AIDEO_LOGI(LOG_TAG_ENC_DEC_WITH_PAST, "Generation cancelled at step %d", step);
+                return {};
+            }
+            if (!stepped) {
                 AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
                            "DecoderWithPast returned empty logits at step %d", step);
                 break;
             }
 
-            nextToken = tokenSelector_->select(nextOutput.logits, vocabSize_, eosTokenId);
             generatedTokens.push_back(nextToken);
-
-            if (nextOutput.kvOutputNames.size() == nextOutput.presentKeyValues.size()) {
-                for (size_t i = 0; i < nextOutput.presentKeyValues.size(); ++i) {
-                    auto [layerIdx, typeOffset] = parseKvOutputName(nextOutput.kvOutputNames[i]);
-                    if (layerIdx >= 0 && layerIdx < numDecoderLayers_ && typeOffset >= 0) {
-                        int targetIdx = layerIdx * 4 + typeOffset;
-                        allKVCache[targetIdx] = std::move(nextOutput.presentKeyValues[i]);
-                        allKVShapes[targetIdx] = std::move(nextOutput.presentKeyValueShapes[i]);
-                    } else if (step == 0) {
-                        AIDEO_LOGW(LOG_TAG_ENC_DEC_WITH_PAST,
-                                   "Update: could not parse KV name: %s",
-                                   nextOutput.kvOutputNames[i].c_str());
-                    }
-                }
-            } else {
-                size_t kvOutputSize = nextOutput.presentKeyValues.size();
-                if (kvOutputSize == static_cast<size_t>(numDecoderLayers_ * 4)) {
-                    allKVCache = std::move(nextOutput.presentKeyValues);
-                    allKVShapes = std::move(nextOutput.presentKeyValueShapes);
-                } else if (kvOutputSize == static_cast<size_t>(numDecoderLayers_ * 2)) {
-                    for (int i = 0; i < numDecoderLayers_; ++i) {
-                        int allIdx = i * 4;
-                        int decIdx = i * 2;
-                        allKVCache[allIdx] = std::move(nextOutput.presentKeyValues[decIdx]);
-                        allKVCache[allIdx + 1] = std::move(nextOutput.presentKeyValues[decIdx + 1]);
-                        allKVShapes[allIdx] = std::move(nextOutput.presentKeyValueShapes[decIdx]);
-                        allKVShapes[allIdx + 1] = std::move(
-                                nextOutput.presentKeyValueShapes[decIdx + 1]);
-                    }
-                } else {
-                    AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST,
-                               "Unexpected KV cache size: %zu", kvOutputSize);
-                    break;
-                }
-            }
         }
     } catch (const std::exception& e) {
         AIDEO_LOGE(LOG_TAG_ENC_DEC_WITH_PAST, "generate failed: %s", e.what());
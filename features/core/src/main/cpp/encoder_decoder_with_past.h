@@ -1,13 +1,21 @@
 #ifndef AIDEO_ENCODER_DECODER_WITH_PAST_H
 #define AIDEO_ENCODER_DECODER_WITH_PAST_H
 
+#include <atomic>
 #include <cstdint>
+#include <initializer_list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
+#include "adaptive_thread_controller.h"
+#include "bump_arena_allocator.h"
+#include "cancellation_token.h"
+#include "kv_cache_buffers.h"
 #include "logging.h"
 #include "onnxruntime_inference.h"
+#include "session_profile.h"
 #include "token_selector.h"
 
 #define LOG_TAG_ENC_DEC_WITH_PAST "EncDecWithPast"
@@ -40,20 +48,85 @@ public:
         std::string encoderValue = "encoder.value";
         std::string logits = "logits";
         std::string presentPrefix = "present.";
+        // merged decoder 전용 입력 — false 면 past_key_values 를 무시하고 첫 step(decoder) 분기를 실행
+        std::string useCacheBranch = "use_cache_branch";
     };
 
-    EncoderDecoderWithPast(
-            int numDecoderLayers,
-            int numHeads,
-            int hiddenSize,
-            int64_t vocabSize
-    );
+    // 세션 키 별 실행 설정
+    struct SessionProfiles {
+        // generateSingle() 은 항상 batch_size = 1
+        // 세 그래프 모두 ORT_ENABLE_ALL 최적화 결과를 디스크에 캐시해 두 번째 로드부터 최적화 단계를 생략
+        // 캐시된 ORT format 모델은 mmap 으로 복사 없이 로드
+        // decoder 와 decoder_with_past 는 같은 decoder 가중치를 가지므로 prepack 결과를 공유
+
+        // 문장당 1회, 긴 입력 전체를 처리 → 공유 스레드 풀 전체 사용
+        SessionProfile encoder = SessionProfile::throughput()
+                .withFreeDimension("batch_size", 1)
+                .withOptimizedModelCache()
+                .withMemoryMappedModel();
+        // 문장당 1회, 초기 decoder 입력(2 토큰) 처리
+        SessionProfile decoder = SessionProfile::throughput()
+                .withFreeDimension("batch_size", 1)
+                .withOptimizedModelCache()
+                .withMemoryMappedModel()
+                .withSharedPrepackedWeights();
+        // 토큰마다 1회, 매우 짧은 Run 이 수백 번 반복 → 소수 전용 스레드 + spin-wait
+        SessionProfile decoderWithPast = SessionProfile::lowLatency()
+                .withFreeDimension("batch_size", 1)
+                .withOptimizedModelCache()
+                .withMemoryMappedModel()
+                .withSharedPrepackedWeights();
+        // loadMerged() 전용. 첫 step 과 이후 step 을 모두 실행하며, 대부분의 Run 은 짧은 cached step
+        // 적응형 스레드의 단계별 세션이 같은 가중치를 쓰므로 prepack 결과를 공유
+        SessionProfile mergedDecoder = SessionProfile::lowLatency()
+                .withFreeDimension("batch_size", 1)
+                .withOptimizedModelCache()
+                .withMemoryMappedModel()
+                .withSharedPrepackedWeights();
+    };
+
+    // 로드 직후 dummy 입력으로 encoder 1회 + decoder 1회 + decoder_with_past 몇 회 실행
+    // → 버퍼 할당, kernel 선택, 가중치 page fault 비용을 사용자의 첫 번역이 아닌 백그라운드 로드에서 지불
+    struct WarmUpConfig {
+        bool enabled = true;
+        // 대표적인 자막 한 줄 길이 (토큰)
+        int encoderLength = 16;
+        int decoderWithPastSteps = 4;
+        // vocab 범위 안의 임의 토큰. 출력은 버려지므로 값 자체는 의미 없음
+        int64_t tokenId = 2;
+    };
+
+    struct LoadOptions {
+        SessionProfiles profiles;
+        WarmUpConfig warmUp;
+        // true 면 cached step 세션을 스레드 수 단계별로 하나씩 더 만들어 두고,
+        // step 시간에 따라 단계를 바꿔 가며 실행 (AdaptiveThreadController)
+        bool adaptiveThreading = false;
+        AdaptiveThreadController::Config threadLevels;
+    };
+
+    // 모델 구조 값. 0 이하인 필드는 "지정하지 않음"
+    struct ModelDimensions {
+        // decoder layer 개수 (KV cache 슬롯 = layer * 4)
+        int numDecoderLayers = 0;
+        int numHeads = 0;
+        int headDim = 0;
+        // numHeads * headDim
+        int hiddenSize = 0;
+        int64_t vocabSize = 0;
+    };
+
+    // 모델 구조 값은 load() 시 세션 입출력 메타데이터에서 추론
+    EncoderDecoderWithPast();
+
+    /**
+     * @param expectedDimensions : 지정한 필드가 세션 메타데이터에서 추론한 값과 다르면 load() 실패.
+     * 메타데이터에서 추론할 수 없는 값(dynamic dimension)은 이 값으로 대체
+     */
+    explicit EncoderDecoderWithPast(const ModelDimensions& expectedDimensions);
 
     EncoderDecoderWithPast(
-            int numDecoderLayers,
-            int numHeads,
-            int hiddenSize,
-            int64_t vocabSize,
+            const ModelDimensions& expectedDimensions,
             EncoderIoConfig&& encoderIoConfig,
             DecoderIoConfig&& decoderIoConfig,
             DecoderWithPastIoConfig&& decoderWithPastIoConfig,
@@ -68,8 +141,97 @@ public:
             const char* decoderWithPastPath
     );
 
+    bool load(
+            const char* encoderPath,
+            const char* decoderPath,
+            const char* decoderWithPastPath,
+            const LoadOptions& options
+    );
+
+    /**
+     * decoder 와 decoder_with_past 대신 Optimum 의 merged decoder(use_cache_branch 입력) 하나로 로드
+     *
+     * decoder 가중치가 한 벌만 올라가고 로드할 그래프도 하나 줄어듦. 기존에 로드된 분리형 decoder 세션은 해제됨
+     */
+    bool loadMerged(
+            const char* encoderPath,
+            const char* mergedDecoderPath
+    );
+
+    bool loadMerged(
+            const char* encoderPath,
+            const char* mergedDecoderPath,
+            const LoadOptions& options
+    );
+
+    bool usesMergedDecoder() const { return useMergedDecoder_; }
+
+    // 마지막 load() / loadMerged() 의 모델 경로 (해당 방식에서 쓰지 않는 모델은 빈 문자열)
+    const std::string& encoderPath() const { return loadedEncoderPath_; }
+
+    const std::string& decoderPath() const { return loadedDecoderPath_; }
+
+    const std::string& decoderWithPastPath() const { return loadedDecoderWithPastPath_; }
+
+    const std::string& mergedDecoderPath() const { return loadedMergedDecoderPath_; }
+
+    /**
+     * dummy 입력으로 encoder 1회 + decode (shape.decoderWithPastSteps + 1) step 을 [iterations] 번 실행한 평균 시간
+     *
+     * 첫 실행(page fault, 버퍼 할당)은 측정에서 제외
+     * @return 실패 시 음수
+     */
+    double measureGenerationMs(const WarmUpConfig& shape, int iterations);
+
+    /**
+     * cached step(decoder_with_past 또는 merged decoder) 1회의 평균 시간
+     *
+     * decode step 이 있는 generation 과 첫 step 만 있는 generation 의 시간 차이를 step 수로 나눔
+     * @return 실패 시 음수
+     */
+    double measureDecodeStepMs(const WarmUpConfig& shape, int iterations);
+
+    struct CrossAttentionBenchmark {
+        // 문장당 첫 step 에서 한 번 계산해 요청 끝까지 고정하는 cross-attention K/V 크기
+        int64_t pinnedBytes = 0;
+        // cached step 마다 더 이상 출력·복사하지 않는 크기 (cached step 세션이 cross-attention K/V 를 다시 내보내지 않으면 0)
+        int64_t savedBytesPerStep = 0;
+        // cached step 1회 평균 (ms), 실패 시 음수
+        double stepMs = -1.0;
+    };
+
+    /**
+     * [shape] 길이 문장의 cross-attention K/V 고정 크기와 cached step 당 절약 바이트, step 시간 측정
+     */
+    CrossAttentionBenchmark benchmarkCrossAttention(const WarmUpConfig& shape, int iterations);
+
+    /**
+     * 로드된 cached step 세션을 같은 모델 경로, [profile] 설정으로 다시 생성 (예: 스레드 배치 비교)
+     *
+     * @return 로드된 모델이 없거나 생성에 실패하면 false
+     */
+    bool reloadCachedStepSession(const SessionProfile& profile);
+
     void release();
 
+    // 마지막 load() 에서 확정된 모델 구조 값
+    const ModelDimensions& modelDimensions() const { return dimensions_; }
+
+    // 세션 메모리 예산 (0 이하면 무제한). 초과 시 사용 중이 아닌 세션을 축출하고 다음 사용 시 다시 로드
+    void setMemoryBudget(int64_t budgetBytes);
+
+    OnnxInference::SessionCacheStats sessionCacheStats() const;
+
+    // encoder / decoder / decoder_with_past 세션을 각각 config.maxRuns 회 profiling (OnnxInference::startProfiling)
+    bool startProfiling(const OnnxInference::ProfilingConfig& config);
+
+    std::vector<OrtProfileSummary> profilingSummaries() const;
+
+    // 세션 키별 Run 시간 통계 (OnnxInference::runStats)
+    std::vector<SessionRunStats> runStats() const;
+
+    void resetRunStats();
+
     /**
      * [encode - decode - decodeWithPast] 까지의 단계를 1 batchSize 로 트리거 \n
      *
@@ -80,69 +242,218 @@ public:
      * @param initialDecoderInputIds : shape = [eosTokenId, tgtLangTokenId]
      * @param eosTokenId : 모델에 구체화된 eosTokenId
      * @param maxLength : 모델에 구체화된 InputIds length
-     * @return
+     * @param cancellation : 취소 시 진행 중인 Session::Run 을 중단하고, 다음 decode step 으로 진행하지 않음 (nullable)
+     * @return 취소되었으면 빈 벡터
      */
     std::vector<int64_t> generateSingle(
             const std::vector<int64_t>& encoderInputIds,
             const std::vector<int64_t>& encoderAttentionMask,
             const std::vector<int64_t>& initialDecoderInputIds,
             int64_t eosTokenId,
-            int maxLength
+            int maxLength,
+            const CancellationToken* cancellation = nullptr
     );
 
 private:
     static constexpr const char* kEncoderSessionKey = "encoder";
     static constexpr const char* kDecoderSessionKey = "decoder";
     static constexpr const char* kDecoderWithPastSessionKey = "decoder_with_past";
+    static constexpr const char* kMergedDecoderSessionKey = "decoder_merged";
 
-    struct DecoderOutput {
-        std::vector<float> logits;
-        std::vector<std::vector<float>> presentKeyValues;
-        std::vector<std::vector<int64_t>> presentKeyValueShapes;
-        std::vector<std::string> kvOutputNames;
+    // 세션 입출력의 역할
+    enum class IoRole {
+        kUnused,
+        kInputIds,
+        // encoder 의 attention_mask, decoder 의 encoder_attention_mask
+        kAttentionMask,
+        kEncoderHiddenStates,
+        kUseCacheBranch,
+        kPastKeyValue,
+        kLastHiddenState,
+        kLogits,
+        kPresentKeyValue,
     };
 
-    /**
-     * KV Cache 에 사용될 output name 에서 layer 단위의 index, type 으로 parsing
-     *
-     * e.g) [present.X.{decoder|encoder}.{key|value}] => {레이어 인덱스, 타입 오프셋(0=decoder_key, 1=decoder_value, 2=encoder_key, 3=encoder_value)}
-     *
-     * @param name : KV Cache output name
-     * @return : {레이어 인덱스, 타입 오프셋(0=decoder_key, 1=decoder_value, 2=encoder_key, 3=encoder_value)}, 실패 시 {-1, -1}
-     */
-    static std::pair<int, int> parseKvOutputName(const std::string& name);
+    // 어떤 io config 로 이름을 분류할지
+    enum class SessionKind {
+        kEncoder,
+        kDecoder,
+        // 분리형 decoder_with_past 와 merged decoder
+        kDecoderWithPast,
+    };
+
+    // 세션 하나의 입출력 이름과 역할 — load 시 한 번 만들고, Run 마다 인덱스로만 접근
+    struct SessionBinding {
+        struct Slot {
+            IoRole role = IoRole::kUnused;
+            // kPastKeyValue / kPresentKeyValue 의 layer * 4 + 타입 오프셋, 그 외 -1
+            int kvSlot = -1;
+        };
+
+        std::vector<std::string> inputNameStrings;
+        // Session::Run 인자. inputNameStrings 를 가리킴
+        std::vector<const char*> inputNames;
+        std::vector<Slot> inputs;
+        // Run 에 요청할 출력만 포함 (사용하지 않는 출력은 제외)
+        std::vector<std::string> outputNameStrings;
+        std::vector<const char*> outputNames;
+        std::vector<Slot> outputs;
+    };
+
+    // generateSingle() 한 번 동안 Run 사이에 유지하는 텐서 — 다음 Run 에 그대로 바인딩 (호스트 측 복사 없음)
+    // step 입력 텐서가 필드를 직접 가리키므로 만든 뒤에는 이동하지 않음
+    struct GenerationState {
+        int64_t encoderSeqLength = 0;
+        // 호출 측 encoderAttentionMask 를 가리킴
+        Ort::Value attentionMask{ nullptr };
+        // arena 에 할당. 요청이 끝날 때까지 유지
+        Ort::Value encoderHiddenStates{ nullptr };
+        // KV 슬롯(layer * 4 + 타입 오프셋) 순서의 past KV.
+        // decoder KV 는 step 마다 present 출력으로 교체, encoder KV 는 첫 step 의 출력을 끝까지 사용
+        std::vector<Ort::Value> pastKeyValues;
+        // decoder present 를 출력할 고정 용량 버퍼 (확보 실패 시 nullptr → ORT 가 step 마다 할당)
+        KvCacheBuffers* kvCache = nullptr;
+        // 현재 past 가 있는 kvCache 절반과 그 길이. present 는 반대쪽 절반에 출력
+        int kvHalf = 0;
+        int64_t pastLength = 0;
+        // ioBinding 이 만들어진 세션 — 첫 step / 스레드 단계 전환 시 바뀜. ioBinding 보다 먼저 선언해 나중에 해제
+        OnnxInference::SessionLease boundSession;
+        Ort::IoBinding ioBinding{ nullptr };
+        // ioBinding 에 마지막으로 바인딩한 SessionBinding — 같으면 이전 바인딩을 지우지 않고 이름별 값만 교체
+        const SessionBinding* boundBinding = nullptr;
+        // ioBinding 에 바인딩한 출력의 SessionBinding::outputs 인덱스 (바인딩 순서)
+        std::vector<size_t> boundOutputs;
+        // SessionBinding::outputs 인덱스별로 미리 할당해 바인딩한 present (null 이면 ORT 가 할당). Run 후 pastKeyValues 로 옮김
+        std::vector<Ort::Value> presentOutputs;
+        // cached step 입력 — 첫 cached step 에 한 번 만든 텐서에 값만 바꿔 바인딩
+        int64_t stepInputId = 0;
+        Ort::Value stepInputIds{ nullptr };
+        bool useCacheBranch = false;
+        Ort::Value useCacheBranchTensor{ nullptr };
+        // cached step logits [1, 1, vocab] — 첫 step logits 버퍼의 앞부분 (확보 실패 시 null → ORT 가 step 마다 할당)
+        Ort::Value stepLogits{ nullptr };
+    };
 
     bool loadModelSession(
             const char* sessionKey,
             const char* modelPath,
             std::string& loadedPath,
-            const char* modelName
+            const char* modelName,
+            const SessionProfile& profile
     );
 
-    std::vector<float> runEncoder(
-            const std::vector<int64_t>& inputIds,
-            const std::vector<int64_t>& attentionMask,
-            int64_t batchSize,
-            int64_t seqLength
+    // 세션 로드 이후의 공통 단계 (메모리 리포트 → 모델 구조 추론 → warm-up)
+    bool completeLoad(const LoadOptions& options, int64_t residentBytesBefore);
+
+    // 첫 step / cached step 을 실행하는 세션 키 (merged 모드에서는 둘 다 merged decoder)
+    const char* firstStepSessionKey() const;
+    const char* cachedStepSessionKey() const;
+
+    // [base] 의 스레드 수만 [threads] 로 바꾼 프로필 (XNNPACK 이면 XNNPACK 스레드 수)
+    static SessionProfile profileForThreadLevel(const SessionProfile& base, int threads);
+
+    // [base] 프로필 기준으로 스레드 단계별 cached step 세션 로드. [base] 와 스레드 수가 같은 단계는 기본 세션 사용
+    // 기본 세션이 로드(최적화 모델 캐시 기록 포함)된 뒤 호출 — 단계별 세션은 그 ORT format 모델로 하나씩 로드
+    bool loadThreadLevelSessions(const SessionProfile& base);
+
+    // 단계별 세션 해제 (기본 cached step 세션은 유지)
+    void releaseThreadLevelSessions();
+
+    // 다음 cached step 을 실행할 세션 키. adaptive 가 꺼져 있으면 기본 세션이고 [level] 은 -1
+    const char* activeCachedStepSessionKey(int& level) const;
+
+    // merged decoder 의 첫 step 용 dummy past KV 를 [state] 에 채움 — use_cache_branch = false 분기에서는 값이 사용되지 않음
+    bool bindDummyPastKeyValues(BumpArenaAllocator& arena, GenerationState& state) const;
+
+    /**
+     * 세 세션의 입출력 이름/shape 으로 모델 구조 값을 추론해 dimensions_ 에 확정
+     *
+     * - layer 수, head 수, head dim : decoder_with_past(또는 merged decoder) 의 past_key_values.N.decoder.key [batch, heads, seq, headDim]
+     * - hidden size : encoder 의 last_hidden_state [batch, seq, hidden] (dynamic 이면 heads * headDim)
+     * - vocab size : decoder(또는 merged decoder) 의 logits [batch, seq, vocab]
+     *
+     * @return expectedDimensions_ 와 불일치하거나 값을 확정할 수 없으면 false
+     */
+    bool inferModelDimensions();
+
+    /**
+     * dummy 입력으로 전체 generation 경로를 짧게 실행하고 결과는 버림
+     *
+     * @return 실패해도 로드는 유효하므로 호출 측은 경고만 남김
+     */
+    bool warmUp(const WarmUpConfig& config);
+
+    // 요청 하나 동안 출력 텐서를 할당할 arena. 풀에 남은 것이 없으면 새로 생성
+    std::unique_ptr<BumpArenaAllocator> acquireArena();
+
+    // reset 후 풀에 반납
+    void releaseArena(std::unique_ptr<BumpArenaAllocator> arena);
+
+    // 요청 하나 동안 decoder KV 를 담을 버퍼. 풀에 남은 것이 없으면 새로 생성 (용량은 호출 측이 reserve)
+    std::unique_ptr<KvCacheBuffers> acquireKvCache();
+
+    void releaseKvCache(std::unique_ptr<KvCacheBuffers> kvCache);
+
+    // [shape] 크기의 float 출력 텐서를 [arena] 에 할당. 실패 시 null Value → ORT 가 직접 할당
+    static Ort::Value arenaOutputTensor(BumpArenaAllocator& arena, std::initializer_list<int64_t> shape);
+
+    // [preallocated] 에 출력하도록 바인딩. null 이면 ORT 가 [memoryInfo] 에 할당
+    static void bindOutput(
+            Ort::IoBinding& ioBinding,
+            const char* name,
+            const Ort::Value& preallocated,
+            const Ort::MemoryInfo& memoryInfo
     );
 
-    DecoderOutput runDecoder(
+    /**
+     * "<prefix>N.{decoder|encoder}.{key|value}" 이름의 KV 슬롯
+     *
+     * @return N * 4 + 타입 오프셋(0=decoder_key, 1=decoder_value, 2=encoder_key, 3=encoder_value), 형식이 다르면 -1
+     */
+    int parseKvSlot(const std::string& name, const std::string& prefix) const;
+
+    // [sessionKey] 세션의 입출력 이름을 [kind] 의 io config 로 분류해 [binding] 구성. 알 수 없는 입력이 있으면 false
+    bool buildSessionBinding(const char* sessionKey, SessionKind kind, SessionBinding& binding);
+
+    // encoder / 첫 step / cached step 세션의 binding 구성 (모델 구조 값 확정 이후).
+    // KV 슬롯이 빠짐없이 이어지지 않으면 false
+    bool buildSessionBindings();
+
+    // 세션별 RSS 증가량 로그 (prepacked weights 공유로 줄어든 메모리 확인용)
+    void logMemoryReport(int64_t totalResidentBytesDelta) const;
+
+    // encoder 를 실행해 [state] 의 attentionMask / encoderHiddenStates 를 채움 (hidden states 는 [arena] 에 유지)
+    bool runEncoder(
+            const Ort::RunOptions& runOptions,
+            BumpArenaAllocator& arena,
             const std::vector<int64_t>& inputIds,
-            const std::vector<int64_t>& encoderAttentionMask,
-            const std::vector<float>& encoderHiddenStates,
-            int64_t batchSize,
-            int64_t decoderSeqLength,
-            int64_t encoderSeqLength
+            const std::vector<int64_t>& attentionMask,
+            GenerationState& state
     );
 
-    DecoderOutput runDecoderWithPast(
-            const std::vector<int64_t>& decoderInputIds,
-            const std::vector<int64_t>& encoderAttentionMask,
-            const std::vector<float>& encoderHiddenStates,
-            const std::vector<std::vector<float>>& pastKeyValues,
-            const std::vector<std::vector<int64_t>>& pastKeyValueShapes,
-            int64_t batchSize,
-            int64_t encoderSeqLength
+    /**
+     * decoder 세션 1 step 을 IoBinding 으로 실행
+     *
+     * 입력은 [state] 의 텐서를 그대로 바인딩하고, present 출력은 [state].pastKeyValues 의 같은 슬롯으로 옮김
+     * cached step 은 [state] 에 유지하는 입력/logits 텐서와 KV 버퍼를 다시 바인딩만 함 (step 마다 버퍼를 할당하지 않음)
+     * @param arena : 첫 step 에서 logits 와 cross-attention K/V 출력을 할당해 요청이 끝날 때까지 유지
+     * @param sessionKey : [binding] 의 세션 키 (cached step 이면 스레드 단계별 세션 중 하나일 수 있음)
+     * @param useCacheBranch : false 면 첫 step — 분리형 decoder, 또는 merged decoder 의 use_cache_branch = false 분기.
+     * 첫 step 에서만 encoder present 를 받고, 이후 step 은 decoder present 만 받음
+     * @param fallbackTokenId : [tokenSelector_] 가 logits 를 읽지 못했을 때 사용할 토큰
+     * @param nextToken : 출력 버퍼의 logits 를 복사하지 않고 [tokenSelector_] 로 고른 다음 토큰
+     * @return logits 를 얻지 못했으면 false
+     */
+    bool runDecoderStep(
+            const Ort::RunOptions& runOptions,
+            BumpArenaAllocator& arena,
+            const char* sessionKey,
+            const SessionBinding& binding,
+            const std::vector<int64_t>& inputIds,
+            bool useCacheBranch,
+            int64_t fallbackTokenId,
+            GenerationState& state,
+            int64_t& nextToken
     );
 
     std::unique_ptr<TokenSelector> tokenSelector_;
@@ -153,10 +464,28 @@ private:
     std::string loadedEncoderPath_;
     std::string loadedDecoderPath_;
     std::string loadedDecoderWithPastPath_;
-    int numDecoderLayers_;
-    int numHeads_;
-    int hiddenSize_;
-    int64_t vocabSize_;
+    std::string loadedMergedDecoderPath_;
+    // loadMerged() 로 로드된 경우 true
+    std::atomic<bool> useMergedDecoder_{ false };
+    // 번역 요청 간 재사용하는 출력 arena — 동시에 실행되는 요청마다 하나씩
+    std::mutex arenaPoolMutex_;
+    std::vector<std::unique_ptr<BumpArenaAllocator>> arenaPool_;
+    // 번역 요청 간 재사용하는 KV 버퍼 — 가장 긴 요청의 용량을 유지
+    std::mutex kvCachePoolMutex_;
+    std::vector<std::unique_ptr<KvCacheBuffers>> kvCachePool_;
+    // 새로 생성된 세션이 있으면 true → 다음 load 에서 warm-up 수행
+    std::atomic<bool> needsWarmUp_{ true };
+    // adaptiveThreading 일 때만 존재. threadLevelSessionKeys_ 는 controller 의 단계 순서와 같음
+    AdaptiveThreadController::Config threadLevelConfig_;
+    std::unique_ptr<AdaptiveThreadController> threadController_;
+    std::vector<std::string> threadLevelSessionKeys_;
+    // load 시 확정한 세션별 입출력 binding (merged 모드에서 첫 step / cached step 은 같은 세션)
+    SessionBinding encoderBinding_;
+    SessionBinding firstStepBinding_;
+    SessionBinding cachedStepBinding_;
+    // 생성자로 지정된 값 (검증 및 추론 실패 시 대체용)
+    ModelDimensions expectedDimensions_;
+    ModelDimensions dimensions_;
 };
 
 #endif
@@ -0,0 +1,65 @@
+#include "kv_cache_buffers.h"
+#include <cstdlib>
+
+namespace {
+    // BumpArenaAllocator 와 같은 cache line 정렬
+    constexpr size_t kAlignment = 64;
+}
+
+KvCacheBuffers::KvCacheBuffers()
+        : memoryInfo_(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault)) {}
+
+KvCacheBuffers::~KvCacheBuffers() {
+    std::free(data_);
+}
+
+size_t KvCacheBuffers::halfElementCount() const {
+    return static_cast<size_t>(numHeads_) * static_cast<size_t>(capacity_) * static_cast<size_t>(headDim_);
+}
+
+size_t KvCacheBuffers::elementCount() const {
+    return static_cast<size_t>(slotCount_) * 2 * halfElementCount();
+}
+
+bool KvCacheBuffers::reserve(int slotCount, int numHeads, int headDim, int64_t capacity) {
+    if (slotCount <= 0 || numHeads <= 0 || headDim <= 0 || capacity <= 0) {
+        AIDEO_LOGE(LOG_TAG_KV_CACHE, "Invalid KV cache shape: slots=%d, heads=%d, headDim=%d, capacity=%lld",
+                   slotCount, numHeads, headDim, static_cast<long long>(capacity));
+        return false;
+    }
+    if (data_ != nullptr && slotCount == slotCount_ && numHeads == numHeads_ && headDim == headDim_ &&
+        capacity <= capacity_) {
+        return true;
+    }
+
+    std::free(data_);
+    data_ = nullptr;
+    slotCount_ = slotCount;
+    numHeads_ = numHeads;
+    headDim_ = headDim;
+    capacity_ = capacity;
+
+    void* data = nullptr;
+    if (posix_memalign(&data, kAlignment, bytes()) != 0) {
+        AIDEO_LOGE(LOG_TAG_KV_CACHE, "Failed to allocate KV cache: %zu bytes", bytes());
+        capacity_ = 0;
+        return false;
+    }
+    data_ = static_cast<float*>(data);
+    AIDEO_LOGI(LOG_TAG_KV_CACHE, "KV cache buffers: %zu bytes (%d slots x 2 x %d heads x %lld x %d)",
+               bytes(), slotCount_, numHeads_, static_cast<long long>(capacity_), headDim_);
+    return true;
+}
+
+Ort::Value KvCacheBuffers::view(int slot, int half, int64_t length) const {
+    if (data_ == nullptr || slot < 0 || slot >= slotCount_ || half < 0 || half > 1 ||
+        length <= 0 || length > capacity_) {
+        return Ort::Value{ nullptr };
+    }
+
+    // 유효 길이만큼의 [heads][length][headDim] 은 절반 버퍼의 앞부분에 연속으로 놓임
+    float* base = data_ + (static_cast<size_t>(slot) * 2 + static_cast<size_t>(half)) * halfElementCount();
+    const int64_t shape[] = { 1, numHeads_, length, headDim_ };
+    const size_t count = static_cast<size_t>(numHeads_) * static_cast<size_t>(length) * static_cast<size_t>(headDim_);
+    return Ort::Value::CreateTensor<float>(memoryInfo_, base, count, shape, 4);
+}
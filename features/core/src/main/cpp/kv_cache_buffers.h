@@ -0,0 +1,66 @@
+#ifndef AIDEO_KV_CACHE_BUFFERS_H
+#define AIDEO_KV_CACHE_BUFFERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "logging.h"
+#include "onnxruntime_cxx_api.h"
+
+#define LOG_TAG_KV_CACHE "KvCache"
+
+/**
+ * decoder self-attention KV 용 고정 용량 ping-pong 버퍼
+ *
+ * dynamic-shape export 는 past 와 새 위치를 모델 안에서 concat 해 present 를 별도 텐서로 내보냄
+ * → 같은 버퍼에 새 위치만 append 할 수 없으므로, 슬롯마다 [2][heads][capacity][headDim] 을 한 번에 할당하고
+ *   step 마다 한쪽 절반은 past(유효 prefix view), 다른 절반은 present 출력으로 번갈아 바인딩
+ *
+ * 요청 사이에 재사용하며, 더 긴 용량이 필요할 때만 다시 할당. 한 번에 한 스레드만 사용해야 함
+ */
+class KvCacheBuffers {
+public:
+    KvCacheBuffers();
+
+    ~KvCacheBuffers();
+
+    KvCacheBuffers(const KvCacheBuffers&) = delete;
+
+    KvCacheBuffers& operator=(const KvCacheBuffers&) = delete;
+
+    /**
+     * [slotCount] 개 슬롯이 각각 [capacity] 위치까지 담을 수 있도록 확보 (이미 충분하면 그대로)
+     *
+     * @param slotCount : decoder layer * 2 (key, value)
+     * @return 할당 실패 시 false (이전 버퍼도 해제됨)
+     */
+    bool reserve(int slotCount, int numHeads, int headDim, int64_t capacity);
+
+    /**
+     * [slot] 의 [half] 쪽 버퍼 앞부분을 [1, heads, length, headDim] 텐서로
+     *
+     * 데이터는 복사/할당하지 않고 OrtValue 헤더만 만듦. ORT 텐서의 shape 은 생성 후 바꿀 수 없고 [length] 는
+     * step 마다 달라지므로 view 를 캐시해 재사용하지 않음 (step 당 2 * layer 개의 헤더 생성)
+     * @return [length] 가 용량을 넘으면 null Value
+     */
+    Ort::Value view(int slot, int half, int64_t length) const;
+
+    int64_t capacity() const { return capacity_; }
+
+    // 두 절반을 포함한 전체 크기
+    size_t bytes() const { return elementCount() * sizeof(float); }
+
+private:
+    size_t elementCount() const;
+
+    // [slot][half] 하나의 float 수
+    size_t halfElementCount() const;
+
+    Ort::MemoryInfo memoryInfo_;
+    float* data_ = nullptr;
+    int slotCount_ = 0;
+    int numHeads_ = 0;
+    int headDim_ = 0;
+    int64_t capacity_ = 0;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "load_task_group.h"
+#include <chrono>
+#include <exception>
+#include <future>
+#include <utility>
+
+LoadTaskGroup::LoadTaskGroup(std::string groupName) : groupName_(std::move(groupName)) {}
+
+void LoadTaskGroup::add(std::string name, std::function<bool()> task) {
+    tasks_.push_back(Task{ std::move(name), std::move(task) });
+}
+
+bool LoadTaskGroup::run() {
+    results_.clear();
+    if (tasks_.empty()) {
+        return true;
+    }
+
+    auto startedAt = std::chrono::steady_clock::now();
+
+    std::vector<std::future<TaskResult>> pending;
+    pending.reserve(tasks_.size() - 1);
+    for (size_t i = 1; i < tasks_.size(); ++i) {
+        pending.push_back(std::async(std::launch::async, &LoadTaskGroup::runTask, std::cref(tasks_[i])));
+    }
+
+    // 실패한 작업이 있어도 나머지 작업이 끝날 때까지 기다림 (작업이 참조하는 객체의 수명 보장)
+    results_.push_back(runTask(tasks_[0]));
+    for (auto& future: pending) {
+        results_.push_back(future.get());
+    }
+
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt).count();
+
+    bool succeeded = true;
+    for (const auto& result: results_) {
+        AIDEO_LOGI(LOG_TAG_LOAD_TASK_GROUP, "[%s] %s: %s in %lld ms",
+                   groupName_.c_str(), result.name.c_str(),
+                   result.succeeded ? "loaded" : "failed", result.elapsedMs);
+        succeeded = succeeded && result.succeeded;
+    }
+    AIDEO_LOGI(LOG_TAG_LOAD_TASK_GROUP, "[%s] total %lld ms", groupName_.c_str(),
+               static_cast<long long>(elapsedMs));
+    return succeeded;
+}
+
+LoadTaskGroup::TaskResult LoadTaskGroup::runTask(const Task& task) {
+    TaskResult result;
+    result.name = task.name;
+
+    auto startedAt = std::chrono::steady_clock::now();
+    try {
+        result.succeeded = task.body();
+    } catch (const std::exception& e) {
+        // 네이티브 예외가 JVM 으로 전파되면 바로 크래시 → 실패로 변환
+        AIDEO_LOGE(LOG_TAG_LOAD_TASK_GROUP, "%s threw: %s", task.name.c_str(), e.what());
+        result.succeeded = false;
+    }
+    result.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt).count();
+    return result;
+}
@@ -0,0 +1,55 @@
+#ifndef AIDEO_LOAD_TASK_GROUP_H
+#define AIDEO_LOAD_TASK_GROUP_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "logging.h"
+
+#define LOG_TAG_LOAD_TASK_GROUP "LoadTaskGroup"
+
+// 서로 독립적인 로드 단계(세션 생성, 토크나이저 파싱 등)를 병렬로 실행하고 단계별 소요 시간을 기록
+class LoadTaskGroup {
+public:
+    struct TaskResult {
+        std::string name;
+        bool succeeded = false;
+        long long elapsedMs = 0;
+    };
+
+    /**
+     * @param groupName : 로그에 표시될 그룹 이름
+     */
+    explicit LoadTaskGroup(std::string groupName);
+
+    /**
+     * @param name : 로그에 표시될 단계 이름
+     * @param task : 성공 여부를 반환. 예외는 실패로 처리
+     */
+    void add(std::string name, std::function<bool()> task);
+
+    /**
+     * 등록된 작업을 모두 병렬 실행하고, 전부 끝날 때까지 대기
+     *
+     * 첫 번째 작업은 호출 스레드에서 실행
+     *
+     * @return 모든 작업이 성공한 경우에만 true
+     */
+    bool run();
+
+    const std::vector<TaskResult>& results() const { return results_; }
+
+private:
+    struct Task {
+        std::string name;
+        std::function<bool()> body;
+    };
+
+    static TaskResult runTask(const Task& task);
+
+    std::string groupName_;
+    std::vector<Task> tasks_;
+    std::vector<TaskResult> results_;
+};
+
+#endif
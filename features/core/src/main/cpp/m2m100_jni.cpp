@@ -1,9 +1,36 @@
 #include <jni.h>
 #include <string>
+#include <vector>
 #include "m2m100_translator.h"
 
 static M2M100Translator* g_translator = nullptr;
 
+namespace {
+    // mode: "none" | "fastest" | "cores" ([cores] 는 "cores" 에서만 사용)
+    bool toThreadAffinity(JNIEnv* env, jstring mode, jintArray cores, ThreadAffinity& affinity) {
+        const char* modeStr = env->GetStringUTFChars(mode, nullptr);
+        std::string modeName(modeStr);
+        env->ReleaseStringUTFChars(mode, modeStr);
+
+        if (modeName == "none") {
+            affinity = ThreadAffinity{};
+        } else if (modeName == "fastest") {
+            affinity = ThreadAffinity::fastestCores();
+        } else if (modeName == "cores") {
+            if (cores == nullptr) {
+                return false;
+            }
+            jsize coreCount = env->GetArrayLength(cores);
+            std::vector<jint> coreIds(static_cast<size_t>(coreCount));
+            env->GetIntArrayRegion(cores, 0, coreCount, coreIds.data());
+            affinity = ThreadAffinity::explicitCores(std::vector<int>(coreIds.begin(), coreIds.end()));
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
+
 extern "C" {
 
 JNIEXPORT jboolean JNICALL
@@ -52,6 +79,75 @@ Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_loadModel(
     return result ? JNI_TRUE : JNI_FALSE;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_loadMergedModel(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring encoderPath,
+        jstring mergedDecoderPath,
+        jstring spModelPath,
+        jstring vocabPath,
+        jstring tokenizerConfigPath) {
+
+    if (g_translator == nullptr) {
+        return JNI_FALSE;
+    }
+
+    const char* encoder = env->GetStringUTFChars(encoderPath, nullptr);
+    const char* mergedDecoder = env->GetStringUTFChars(mergedDecoderPath, nullptr);
+    const char* spModel = env->GetStringUTFChars(spModelPath, nullptr);
+    const char* vocab = env->GetStringUTFChars(vocabPath, nullptr);
+    const char* tokenizerConfig = env->GetStringUTFChars(tokenizerConfigPath, nullptr);
+
+    bool result = g_translator->loadMerged(encoder, mergedDecoder, spModel, vocab, tokenizerConfig);
+
+    env->ReleaseStringUTFChars(encoderPath, encoder);
+    env->ReleaseStringUTFChars(mergedDecoderPath, mergedDecoder);
+    env->ReleaseStringUTFChars(spModelPath, spModel);
+    env->ReleaseStringUTFChars(vocabPath, vocab);
+    env->ReleaseStringUTFChars(tokenizerConfigPath, tokenizerConfig);
+
+    return result ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jstring JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_loadBestModelVariant(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring modelDirectory,
+        jstring modelPrefix,
+        jstring selectionPath,
+        jstring spModelPath,
+        jstring vocabPath,
+        jstring tokenizerConfigPath) {
+
+    if (g_translator == nullptr) {
+        return nullptr;
+    }
+
+    const char* directory = env->GetStringUTFChars(modelDirectory, nullptr);
+    const char* prefix = env->GetStringUTFChars(modelPrefix, nullptr);
+    const char* selection = env->GetStringUTFChars(selectionPath, nullptr);
+    const char* spModel = env->GetStringUTFChars(spModelPath, nullptr);
+    const char* vocab = env->GetStringUTFChars(vocabPath, nullptr);
+    const char* tokenizerConfig = env->GetStringUTFChars(tokenizerConfigPath, nullptr);
+
+    std::string variant = g_translator->loadBestVariant(
+            directory, prefix, selection, spModel, vocab, tokenizerConfig);
+
+    env->ReleaseStringUTFChars(modelDirectory, directory);
+    env->ReleaseStringUTFChars(modelPrefix, prefix);
+    env->ReleaseStringUTFChars(selectionPath, selection);
+    env->ReleaseStringUTFChars(spModelPath, spModel);
+    env->ReleaseStringUTFChars(vocabPath, vocab);
+    env->ReleaseStringUTFChars(tokenizerConfigPath, tokenizerConfig);
+
+    if (variant.empty()) {
+        return nullptr;
+    }
+    return env->NewStringUTF(variant.c_str());
+}
+
 JNIEXPORT jstring JNICALL
 Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_translateWithBuffer(
         JNIEnv* env,
@@ -60,7 +156,8 @@ Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_translateWithBu
         jint textLength,
         jstring srcLang,
         jstring tgtLang,
-        jint maxLength) {
+        jint maxLength,
+        jlong requestId) {
 
     if (g_translator == nullptr) {
         return nullptr;
@@ -76,7 +173,8 @@ Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_translateWithBu
     const char* srcLangStr = env->GetStringUTFChars(srcLang, nullptr);
     const char* tgtLangStr = env->GetStringUTFChars(tgtLang, nullptr);
 
-    std::string result = g_translator->translate(text, srcLangStr, tgtLangStr, maxLength);
+    std::string result = g_translator->translate(
+            text, srcLangStr, tgtLangStr, maxLength, static_cast<int64_t>(requestId));
 
     env->ReleaseStringUTFChars(srcLang, srcLangStr);
     env->ReleaseStringUTFChars(tgtLang, tgtLangStr);
@@ -88,6 +186,223 @@ Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_translateWithBu
     return env->NewStringUTF(result.c_str());
 }
 
+JNIEXPORT void JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_cancel(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong requestId) {
+    // translateWithBuffer() 를 실행 중인(또는 곧 실행할) 스레드와 다른 스레드에서 호출됨
+    if (g_translator != nullptr) {
+        g_translator->cancel(static_cast<int64_t>(requestId));
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_setExecutionProvider(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring provider,
+        jint xnnpackThreads) {
+    if (g_translator == nullptr) {
+        return JNI_FALSE;
+    }
+
+    const char* providerStr = env->GetStringUTFChars(provider, nullptr);
+    std::string providerName(providerStr);
+    env->ReleaseStringUTFChars(provider, providerStr);
+
+    if (providerName == "cpu") {
+        g_translator->setExecutionProvider(SessionProfile::ExecutionProvider::kCpu);
+    } else if (providerName == "xnnpack") {
+        g_translator->setExecutionProvider(
+                SessionProfile::ExecutionProvider::kXnnpackWithCpuFallback, xnnpackThreads);
+    } else {
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_setThreadAffinity(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring mode,
+        jintArray cores) {
+    if (g_translator == nullptr) {
+        return JNI_FALSE;
+    }
+
+    ThreadAffinity affinity;
+    if (!toThreadAffinity(env, mode, cores, affinity)) {
+        return JNI_FALSE;
+    }
+    g_translator->setThreadAffinity(affinity);
+    return JNI_TRUE;
+}
+
+JNIEXPORT void JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_setAdaptiveThreading(
+        JNIEnv* env,
+        jobject /* this */,
+        jintArray threadLevels) {
+    if (g_translator == nullptr) {
+        return;
+    }
+
+    std::vector<int> levels;
+    if (threadLevels != nullptr) {
+        jsize levelCount = env->GetArrayLength(threadLevels);
+        std::vector<jint> values(static_cast<size_t>(levelCount));
+        env->GetIntArrayRegion(threadLevels, 0, levelCount, values.data());
+        levels.assign(values.begin(), values.end());
+    }
+    g_translator->setAdaptiveThreading(levels);
+}
+
+// [unpinnedStepMs, pinnedStepMs]
+JNIEXPORT jdoubleArray JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_benchmarkThreadAffinity(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring mode,
+        jintArray cores) {
+    if (g_translator == nullptr) {
+        return nullptr;
+    }
+
+    ThreadAffinity pinned;
+    if (!toThreadAffinity(env, mode, cores, pinned)) {
+        return nullptr;
+    }
+    auto benchmark = g_translator->benchmarkThreadAffinity(pinned);
+    const jdouble values[] = {
+            static_cast<jdouble>(benchmark.unpinnedStepMs),
+            static_cast<jdouble>(benchmark.pinnedStepMs),
+    };
+    constexpr jsize kValueCount = sizeof(values) / sizeof(values[0]);
+
+    jdoubleArray result = env->NewDoubleArray(kValueCount);
+    if (result == nullptr) {
+        return nullptr;
+    }
+    env->SetDoubleArrayRegion(result, 0, kValueCount, values);
+    return result;
+}
+
+// [pinnedBytes, savedBytesPerStep, stepMs]
+JNIEXPORT jdoubleArray JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_benchmarkCrossAttention(
+        JNIEnv* env,
+        jobject /* this */) {
+    if (g_translator == nullptr || !g_translator->isLoaded()) {
+        return nullptr;
+    }
+
+    auto benchmark = g_translator->benchmarkCrossAttention();
+    const jdouble values[] = {
+            static_cast<jdouble>(benchmark.pinnedBytes),
+            static_cast<jdouble>(benchmark.savedBytesPerStep),
+            static_cast<jdouble>(benchmark.stepMs),
+    };
+    constexpr jsize kValueCount = sizeof(values) / sizeof(values[0]);
+
+    jdoubleArray result = env->NewDoubleArray(kValueCount);
+    if (result == nullptr) {
+        return nullptr;
+    }
+    env->SetDoubleArrayRegion(result, 0, kValueCount, values);
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_setSessionMemoryBudget(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong budgetBytes) {
+    if (g_translator != nullptr) {
+        g_translator->setSessionMemoryBudget(static_cast<int64_t>(budgetBytes));
+    }
+}
+
+// [hits, misses, evictions, residentBytes, memoryBudgetBytes, residentSessions, registeredSessions]
+JNIEXPORT jlongArray JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_getSessionCacheStats(
+        JNIEnv* env,
+        jobject /* this */) {
+    if (g_translator == nullptr) {
+        return nullptr;
+    }
+
+    auto stats = g_translator->sessionCacheStats();
+    const jlong values[] = {
+            static_cast<jlong>(stats.hits),
+            static_cast<jlong>(stats.misses),
+            static_cast<jlong>(stats.evictions),
+            static_cast<jlong>(stats.residentBytes),
+            static_cast<jlong>(stats.memoryBudgetBytes),
+            static_cast<jlong>(stats.residentSessions),
+            static_cast<jlong>(stats.registeredSessions),
+    };
+    constexpr jsize kValueCount = sizeof(values) / sizeof(values[0]);
+
+    jlongArray result = env->NewLongArray(kValueCount);
+    if (result == nullptr) {
+        return nullptr;
+    }
+    env->SetLongArrayRegion(result, 0, kValueCount, values);
+    return result;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_startProfiling(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring outputDirectory,
+        jint maxRuns,
+        jint topOpCount) {
+    if (g_translator == nullptr) {
+        return JNI_FALSE;
+    }
+
+    const char* outputDirectoryStr = env->GetStringUTFChars(outputDirectory, nullptr);
+    OnnxInference::ProfilingConfig config;
+    config.outputDirectory = outputDirectoryStr;
+    config.maxRuns = maxRuns;
+    config.topOpCount = topOpCount;
+    env->ReleaseStringUTFChars(outputDirectory, outputDirectoryStr);
+
+    return g_translator->startProfiling(config) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jstring JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_getProfilingSummary(
+        JNIEnv* env,
+        jobject /* this */) {
+    if (g_translator == nullptr) {
+        return nullptr;
+    }
+    return env->NewStringUTF(g_translator->profilingSummaryJson().c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_getRunStats(
+        JNIEnv* env,
+        jobject /* this */) {
+    if (g_translator == nullptr) {
+        return nullptr;
+    }
+    return env->NewStringUTF(g_translator->runStatsJson().c_str());
+}
+
+JNIEXPORT void JNICALL
+Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_resetRunStats(
+        JNIEnv* env,
+        jobject /* this */) {
+    if (g_translator != nullptr) {
+        g_translator->resetRunStats();
+    }
+}
+
 JNIEXPORT void JNICALL
 Java_jinproject_aideo_core_inference_native_wrapper_M2M100Native_release(
         JNIEnv* env,
@@ -4,17 +4,19 @@
 
 #include "m2m100_translator.h"
 #include "json.hpp"
+#include "load_task_group.h"
 #include "path_utils.h"
+#include <algorithm>
 #include <exception>
 #include <fstream>
+#include <functional>
 #include <utility>
 #include <vector>
 
 using json = nlohmann::json;
 
-M2M100Translator::M2M100Translator()
-        : decoder_(NUM_DECODER_LAYERS, NUM_HEADS, HIDDEN_SIZE, VOCAB_SIZE) {
-}
+// layer/head/hidden/vocab 크기는 로드한 모델에서 읽음 → 418M, distilled 등 다른 M2M100 체크포인트도 재컴파일 없이 사용
+M2M100Translator::M2M100Translator() = default;
 
 M2M100Translator::~M2M100Translator() {
     release();
@@ -28,50 +30,242 @@ bool M2M100Translator::load(
         const char* vocabPath,
         const char* tokenizerConfigPath
 ) {
-    setLoaded(false);
+    const auto options = loadOptionsSnapshot();
+    return loadComponents([&](EncoderDecoderWithPast& decoder) {
+        return decoder.load(encoderPath, decoderPath, decoderWithPastPath, options);
+    }, spModelPath, vocabPath, tokenizerConfigPath);
+}
+
+bool M2M100Translator::loadMerged(
+        const char* encoderPath,
+        const char* mergedDecoderPath,
+        const char* spModelPath,
+        const char* vocabPath,
+        const char* tokenizerConfigPath
+) {
+    const auto options = loadOptionsSnapshot();
+    return loadComponents([&](EncoderDecoderWithPast& decoder) {
+        return decoder.loadMerged(encoderPath, mergedDecoderPath, options);
+    }, spModelPath, vocabPath, tokenizerConfigPath);
+}
+
+std::string M2M100Translator::loadBestVariant(
+        const char* modelDirectory,
+        const char* modelPrefix,
+        const char* selectionPath,
+        const char* spModelPath,
+        const char* vocabPath,
+        const char* tokenizerConfigPath
+) {
+    if (aideo::isInvalidPath(modelDirectory) || aideo::isInvalidPath(modelPrefix) ||
+        aideo::isInvalidPath(selectionPath)) {
+        AIDEO_LOGE(LOG_TAG_M2M100, "Invalid model variant paths");
+        return "";
+    }
+
+    ModelVariantRegistry registry;
+    if (registry.discover(modelDirectory, modelPrefix) == 0) {
+        AIDEO_LOGE(LOG_TAG_M2M100, "No model variants in %s", modelDirectory);
+        return "";
+    }
+
+    // 측정은 예산 없는 별도 인스턴스에서 실행 → 예산에 의한 축출/재로드가 측정 시간에 섞이지 않음
+    const auto* variant = registry.select(
+            selectionPath, memoryBudgetBytes_.load(),
+            [this](const ModelVariantRegistry::Variant& candidate) {
+                return benchmarkVariant(candidate);
+            });
+    if (variant == nullptr) {
+        return "";
+    }
+
+    bool loaded = variant->usesMergedDecoder()
+                  ? loadMerged(variant->encoderPath.c_str(), variant->mergedDecoderPath.c_str(),
+                               spModelPath, vocabPath, tokenizerConfigPath)
+                  : load(variant->encoderPath.c_str(), variant->decoderPath.c_str(),
+                         variant->decoderWithPastPath.c_str(),
+                         spModelPath, vocabPath, tokenizerConfigPath);
+    return loaded ? variant->name : "";
+}
+
+ModelVariantRegistry::Measurement M2M100Translator::benchmarkVariant(
+        const ModelVariantRegistry::Variant& variant) {
+    // 자막 한 줄 분량의 encoder 입력 + 짧은 decode
+    static constexpr int kBenchmarkEncoderLength = 24;
+    static constexpr int kBenchmarkDecodeSteps = 16;
+    static constexpr int kBenchmarkIterations = 3;
+
+    ModelVariantRegistry::Measurement measurement;
+    // 현재 세트는 그대로 두고 별도 인스턴스로 측정 → 측정 중에도 기존 모델로 번역 가능
+    EncoderDecoderWithPast decoder;
+
+    // 선택되지 않을 variant 의 최적화 모델 캐시가 디스크에 남지 않도록 측정 중에는 캐시 미사용
+    auto options = loadOptionsSnapshot();
+    options.warmUp.enabled = false;
+    options.profiles.encoder = options.profiles.encoder.withOptimizedModelCache(false);
+    options.profiles.decoder = options.profiles.decoder.withOptimizedModelCache(false);
+    options.profiles.decoderWithPast = options.profiles.decoderWithPast.withOptimizedModelCache(false);
+    options.profiles.mergedDecoder = options.profiles.mergedDecoder.withOptimizedModelCache(false);
+
+    bool loaded = variant.usesMergedDecoder()
+                  ? decoder.loadMerged(variant.encoderPath.c_str(),
+                                       variant.mergedDecoderPath.c_str(), options)
+                  : decoder.load(variant.encoderPath.c_str(), variant.decoderPath.c_str(),
+                                 variant.decoderWithPastPath.c_str(), options);
+    if (loaded) {
+        EncoderDecoderWithPast::WarmUpConfig shape;
+        shape.encoderLength = kBenchmarkEncoderLength;
+        shape.decoderWithPastSteps = kBenchmarkDecodeSteps;
+        double generationMs = decoder.measureGenerationMs(shape, kBenchmarkIterations);
+        measurement.succeeded = generationMs >= 0.0;
+        measurement.generationMs = generationMs;
+        measurement.residentBytes = decoder.sessionCacheStats().residentBytes;
+    }
+
+    decoder.release();
+    return measurement;
+}
+
+bool M2M100Translator::loadComponents(
+        const std::function<bool(EncoderDecoderWithPast&)>& loadOnnxModels,
+        const char* spModelPath,
+        const char* vocabPath,
+        const char* tokenizerConfigPath
+) {
+    if (aideo::isInvalidPath(spModelPath) || aideo::isInvalidPath(vocabPath) ||
+        aideo::isInvalidPath(tokenizerConfigPath)) {
+        AIDEO_LOGE(LOG_TAG_M2M100, "Invalid tokenizer paths");
+        return false;
+    }
+
+    // 기존 세트는 새 세트가 준비될 때까지 계속 번역에 사용 → setLoaded(false) 하지 않음
+    auto next = std::make_unique<ModelSet>();
+    next->spModelPath = spModelPath;
+    next->vocabPath = vocabPath;
+    next->tokenizerConfigPath = tokenizerConfigPath;
+    const int64_t memoryBudgetBytes = memoryBudgetBytes_.load();
+    if (memoryBudgetBytes > 0) {
+        next->decoder.setMemoryBudget(memoryBudgetBytes);
+    }
+    {
+        // variant / 경로만 바뀌는 교체에서는 토크나이저 파일이 같으므로 다시 파싱하지 않음
+        std::lock_guard<std::mutex> lock(modelMutex_);
+        if (model_ != nullptr) {
+            if (model_->spModelPath == next->spModelPath && model_->vocabPath == next->vocabPath) {
+                next->tokenizer = model_->tokenizer;
+            }
+            if (model_->tokenizerConfigPath == next->tokenizerConfigPath) {
+                next->languageTokens = model_->languageTokens;
+            }
+        }
+    }
 
     try {
+        // 세션 생성, 토크나이저 파싱, 언어 토큰 파싱은 첫 translate() 전까지 서로 독립적 → 병렬 실행
+        LoadTaskGroup taskGroup("M2M100");
+
         // 1. ONNX 모델 로드
-        if (!decoder_.load(encoderPath, decoderPath, decoderWithPastPath)) {
-            AIDEO_LOGE(LOG_TAG_M2M100, "Failed to load ONNX models");
-            return false;
-        }
+        taskGroup.add("onnx models", [&]() {
+            if (!loadOnnxModels(next->decoder)) {
+                AIDEO_LOGE(LOG_TAG_M2M100, "Failed to load ONNX models");
+                return false;
+            }
+            return true;
+        });
 
         // 2. 토크나이저 로드 (SentencePiece model + vocab.json)
-        if (!tokenizer_.load(spModelPath, vocabPath)) {
-            AIDEO_LOGE(LOG_TAG_M2M100, "Failed to load tokenizer");
-            return false;
+        if (next->tokenizer == nullptr) {
+            auto tokenizer = std::make_shared<Tokenizer>();
+            next->tokenizer = tokenizer;
+            taskGroup.add("tokenizer", [tokenizer, spModelPath, vocabPath]() {
+                if (!tokenizer->load(spModelPath, vocabPath)) {
+                    AIDEO_LOGE(LOG_TAG_M2M100, "Failed to load tokenizer");
+                    return false;
+                }
+                return true;
+            });
         }
 
         // 3. 언어 토큰 매핑 로드 (tokenizer_config.json의 added_tokens_decoder에서 추출)
-        if (!loadLanguageTokens(tokenizerConfigPath)) {
-            AIDEO_LOGE(LOG_TAG_M2M100, "Failed to load language token map");
+        if (next->languageTokens == nullptr) {
+            auto languageTokens = std::make_shared<LanguageTokenMap>();
+            next->languageTokens = languageTokens;
+            taskGroup.add("language tokens", [languageTokens, tokenizerConfigPath]() {
+                if (!loadLanguageTokens(tokenizerConfigPath, *languageTokens)) {
+                    AIDEO_LOGE(LOG_TAG_M2M100, "Failed to load language token map");
+                    return false;
+                }
+                return true;
+            });
+        }
+
+        // 하나라도 실패하면 새 세트를 버리고 기존 세트 유지
+        if (!taskGroup.run()) {
             return false;
         }
 
         // 특수 토큰 설정 (M2M100 자체 멤버 — base 에는 special token 개념 없음)
-        eosTokenId_ = tokenizer_.getEosTokenId();
-        setLoaded(true);
-        return true;
+        next->eosTokenId = next->tokenizer->getEosTokenId();
 
     } catch (const std::exception& e) {
         // 네이티브 메모리 공간에서 발생한 예외를 JVM 에서 잡을 수 없기 때문에(바로 크래시 발생) 예외 처리가 매우 중요
         AIDEO_LOGE(LOG_TAG_M2M100, "Failed to load M2M100: %s", e.what());
         return false;
     }
+
+    swapModelSet(std::move(next));
+    setLoaded(true);
+    return true;
 }
 
-bool M2M100Translator::loadLanguageTokens(const char* tokenizerConfigPath) {
+void M2M100Translator::swapModelSet(std::unique_ptr<ModelSet> next) {
+    std::unique_ptr<ModelSet> previous;
+    {
+        std::unique_lock<std::mutex> lock(modelMutex_);
+        previous = std::move(model_);
+        model_ = std::move(next);
+        // 로드 중에 setSessionMemoryBudget() 이 이전 세트에만 적용되었을 수 있으므로 교체 시점의 예산으로 다시 맞춤
+        // (이후 호출은 lease 로 새 세트에 적용됨)
+        if (model_ != nullptr) {
+            model_->decoder.setMemoryBudget(memoryBudgetBytes_.load());
+        }
+        // 이후 시작하는 번역은 이미 새 세트를 사용 → 이전 세트를 쓰는 번역만 기다림
+        modelDrained_.wait(lock, [&previous]() {
+            return previous == nullptr || previous->activeRequests == 0;
+        });
+    }
+    // 세션 해제는 lock 밖에서 (번역 시작을 막지 않도록)
+    if (previous != nullptr) {
+        previous->decoder.release();
+    }
+}
+
+M2M100Translator::ModelLease::ModelLease(const M2M100Translator& owner) : owner_(owner) {
+    std::lock_guard<std::mutex> lock(owner_.modelMutex_);
+    model_ = owner_.model_.get();
+    if (model_ != nullptr) {
+        ++model_->activeRequests;
+    }
+}
+
+M2M100Translator::ModelLease::~ModelLease() {
+    if (model_ == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(owner_.modelMutex_);
+    if (--model_->activeRequests == 0) {
+        owner_.modelDrained_.notify_all();
+    }
+}
+
+bool M2M100Translator::loadLanguageTokens(
+        const char* tokenizerConfigPath,
+        LanguageTokenMap& languageTokens) {
     if (aideo::isInvalidPath(tokenizerConfigPath)) {
         AIDEO_LOGE(LOG_TAG_M2M100, "Invalid tokenizer_config.json path");
         return false;
     }
 
-    std::string nextPath(tokenizerConfigPath);
-    if (!languageTokens_.empty() && loadedTokenizerConfigPath_ == nextPath) {
-        return true;
-    }
-
     std::ifstream file(tokenizerConfigPath);
     if (!file.is_open()) {
         AIDEO_LOGE(LOG_TAG_M2M100, "Failed to open tokenizer_config.json");
@@ -108,8 +302,7 @@ bool M2M100Translator::loadLanguageTokens(const char* tokenizerConfigPath) {
             return false;
         }
 
-        languageTokens_ = std::move(nextLanguageTokens);
-        loadedTokenizerConfigPath_ = std::move(nextPath);
+        languageTokens = std::move(nextLanguageTokens);
         return true;
     } catch (const std::exception& e) {
         AIDEO_LOGE(LOG_TAG_M2M100, "Failed to parse tokenizer_config.json: %s", e.what());
@@ -122,15 +315,58 @@ std::string M2M100Translator::translate(
         const std::string& srcLang,
         const std::string& tgtLang,
         int maxLength) {
+    return translate(text, srcLang, tgtLang, maxLength, kNoRequestId);
+}
+
+std::string M2M100Translator::translate(
+        const std::string& text,
+        const std::string& srcLang,
+        const std::string& tgtLang,
+        int maxLength,
+        int64_t requestId) {
+    // 요청마다 별도 토큰 → 다른 요청의 cancel() / 시작이 이 요청의 취소 상태나 RunOptions 를 바꾸지 않음
+    struct CancellationRegistration {
+        M2M100Translator& owner;
+        CancellationToken token;
+
+        CancellationRegistration(M2M100Translator& translator, int64_t requestId) : owner(translator) {
+            std::lock_guard<std::mutex> lock(owner.cancellationsMutex_);
+            owner.activeCancellations_.emplace(&token, requestId);
+            // 시작 전에 도착한 cancel(requestId) 반영
+            auto& pending = owner.pendingCancellations_;
+            auto cancelled = std::find(pending.begin(), pending.end(), requestId);
+            if (requestId != kNoRequestId && cancelled != pending.end()) {
+                pending.erase(cancelled);
+                token.cancel();
+            }
+        }
+
+        ~CancellationRegistration() {
+            std::lock_guard<std::mutex> lock(owner.cancellationsMutex_);
+            owner.activeCancellations_.erase(&token);
+        }
+    } registration(*this, requestId);
 
-    if (!isLoaded()) {
+    return translate(text, srcLang, tgtLang, maxLength, registration.token);
+}
+
+std::string M2M100Translator::translate(
+        const std::string& text,
+        const std::string& srcLang,
+        const std::string& tgtLang,
+        int maxLength,
+        const CancellationToken& cancellation) {
+
+    // 요청이 끝날 때까지 같은 세트 사용 — 도중에 load() 가 교체해도 이 요청이 끝난 뒤 해제됨
+    ModelLease model(*this);
+    if (!isLoaded() || !model) {
         AIDEO_LOGE(LOG_TAG_M2M100, "Model not loaded");
         return "";
     }
 
     int64_t srcLangId;
     int64_t tgtLangId;
-    if (!languageTokens_.resolvePair(srcLang, tgtLang, srcLangId, tgtLangId)) {
+    if (!model->languageTokens->resolvePair(srcLang, tgtLang, srcLangId, tgtLangId)) {
         AIDEO_LOGE(LOG_TAG_M2M100, "Unsupported language: src=%s, tgt=%s",
                    srcLang.c_str(), tgtLang.c_str());
         return "";
@@ -138,25 +374,28 @@ std::string M2M100Translator::translate(
 
     try {
         // 1. M2M100 형식 encoder input: [srcLangId, ...textTokens, eos]
-        auto textTokens = tokenizer_.encode(text);
+        auto textTokens = model->tokenizer->encode(text);
 
         std::vector<int64_t> encoderInputIds;
         encoderInputIds.reserve(textTokens.size() + 2);
         encoderInputIds.push_back(srcLangId);
         encoderInputIds.insert(encoderInputIds.end(), textTokens.begin(), textTokens.end());
-        encoderInputIds.push_back(eosTokenId_);
+        encoderInputIds.push_back(model->eosTokenId);
         std::vector<int64_t> encoderAttentionMask(encoderInputIds.size(), 1);
 
         // 2. M2M100 형식 initial decoder input: [eos, tgtLangId]
-        std::vector<int64_t> initialDecoderInputIds = { eosTokenId_, tgtLangId };
+        std::vector<int64_t> initialDecoderInputIds = { model->eosTokenId, tgtLangId };
 
         // 3. 디코딩
-        auto generatedTokens = decoder_.generateSingle(
-                encoderInputIds, encoderAttentionMask, initialDecoderInputIds, eosTokenId_,
-                maxLength);
+        auto generatedTokens = model->decoder.generateSingle(
+                encoderInputIds, encoderAttentionMask, initialDecoderInputIds, model->eosTokenId,
+                maxLength, &cancellation);
+        if (cancellation.isCancelled()) {
+            return "";
+        }
 
         // 4. 토큰 디코딩
-        return tokenizer_.decode(generatedTokens);
+        return model->tokenizer->decode(generatedTokens);
 
     } catch (const std::exception& e) {
         AIDEO_LOGE(LOG_TAG_M2M100, "Translation failed: %s", e.what());
@@ -164,10 +403,199 @@ std::string M2M100Translator::translate(
     }
 }
 
+void M2M100Translator::setExecutionProvider(
+        SessionProfile::ExecutionProvider provider,
+        int xnnpackThreads) {
+    std::lock_guard<std::mutex> lock(settingsMutex_);
+    auto& profiles = loadOptions_.profiles;
+    profiles = EncoderDecoderWithPast::SessionProfiles{};
+    if (provider == SessionProfile::ExecutionProvider::kXnnpackWithCpuFallback) {
+        profiles.encoder = profiles.encoder.withXnnpack(xnnpackThreads);
+        profiles.decoder = profiles.decoder.withXnnpack(xnnpackThreads);
+        profiles.decoderWithPast = profiles.decoderWithPast.withXnnpack(xnnpackThreads);
+        profiles.mergedDecoder = profiles.mergedDecoder.withXnnpack(xnnpackThreads);
+    }
+    profiles.decoderWithPast = profiles.decoderWithPast.withThreadAffinity(cachedStepAffinity_);
+    profiles.mergedDecoder = profiles.mergedDecoder.withThreadAffinity(cachedStepAffinity_);
+}
+
+void M2M100Translator::setThreadAffinity(const ThreadAffinity& affinity) {
+    std::lock_guard<std::mutex> lock(settingsMutex_);
+    cachedStepAffinity_ = affinity;
+    auto& profiles = loadOptions_.profiles;
+    profiles.decoderWithPast = profiles.decoderWithPast.withThreadAffinity(affinity);
+    profiles.mergedDecoder = profiles.mergedDecoder.withThreadAffinity(affinity);
+}
+
+void M2M100Translator::setAdaptiveThreading(const std::vector<int>& threadLevels) {
+    std::lock_guard<std::mutex> lock(settingsMutex_);
+    loadOptions_.adaptiveThreading = !threadLevels.empty();
+    if (loadOptions_.adaptiveThreading) {
+        loadOptions_.threadLevels.threadLevels = threadLevels;
+    }
+}
+
+EncoderDecoderWithPast::LoadOptions M2M100Translator::loadOptionsSnapshot() const {
+    std::lock_guard<std::mutex> lock(settingsMutex_);
+    return loadOptions_;
+}
+
+M2M100Translator::ThreadAffinityBenchmark M2M100Translator::benchmarkThreadAffinity(
+        const ThreadAffinity& pinned) {
+    // step 시간 차이가 드러나도록 benchmarkVariant 보다 긴 decode
+    static constexpr int kBenchmarkEncoderLength = 24;
+    static constexpr int kBenchmarkDecodeSteps = 32;
+    static constexpr int kBenchmarkIterations = 3;
+
+    ThreadAffinityBenchmark result;
+    bool merged = false;
+    std::string encoderPath;
+    std::string decoderPath;
+    std::string decoderWithPastPath;
+    {
+        // 경로만 복사하고 lease 는 바로 반납 → 측정 중에 load() 가 교체를 끝낼 수 있음
+        ModelLease model(*this);
+        if (!isLoaded() || !model) {
+            AIDEO_LOGE(LOG_TAG_M2M100, "Model is not loaded");
+            return result;
+        }
+        merged = model->decoder.usesMergedDecoder();
+        encoderPath = model->decoder.encoderPath();
+        decoderPath = merged ? model->decoder.mergedDecoderPath() : model->decoder.decoderPath();
+        decoderWithPastPath = model->decoder.decoderWithPastPath();
+    }
+
+    // 현재 세트는 그대로 두고 같은 모델의 별도 인스턴스로 측정 (benchmarkVariant 와 같은 방식)
+    // 단계 전환 없이 한 가지 배치만 측정하고, 첫 실행은 측정에서 제외되므로 warm-up 생략
+    auto options = loadOptionsSnapshot();
+    options.warmUp.enabled = false;
+    options.adaptiveThreading = false;
+    SessionProfile& cachedStep = merged ? options.profiles.mergedDecoder
+                                        : options.profiles.decoderWithPast;
+    const SessionProfile current = cachedStep;
+    cachedStep = current.withThreadAffinity(ThreadAffinity{});
+
+    EncoderDecoderWithPast decoder;
+    bool loaded = merged
+                  ? decoder.loadMerged(encoderPath.c_str(), decoderPath.c_str(), options)
+                  : decoder.load(encoderPath.c_str(), decoderPath.c_str(),
+                                 decoderWithPastPath.c_str(), options);
+    if (!loaded) {
+        AIDEO_LOGE(LOG_TAG_M2M100, "Failed to load benchmark model");
+        decoder.release();
+        return result;
+    }
+
+    EncoderDecoderWithPast::WarmUpConfig shape;
+    shape.encoderLength = kBenchmarkEncoderLength;
+    shape.decoderWithPastSteps = kBenchmarkDecodeSteps;
+    result.unpinnedStepMs = decoder.measureDecodeStepMs(shape, kBenchmarkIterations);
+    if (decoder.reloadCachedStepSession(current.withThreadAffinity(pinned))) {
+        result.pinnedStepMs = decoder.measureDecodeStepMs(shape, kBenchmarkIterations);
+    }
+    AIDEO_LOGI(LOG_TAG_M2M100, "Decode step: unpinned=%.2f ms, pinned=%.2f ms",
+               result.unpinnedStepMs, result.pinnedStepMs);
+
+    decoder.release();
+    return result;
+}
+
+EncoderDecoderWithPast::CrossAttentionBenchmark M2M100Translator::benchmarkCrossAttention() {
+    // benchmarkThreadAffinity 와 같은 문장 길이 / decode 길이
+    static constexpr int kBenchmarkEncoderLength = 24;
+    static constexpr int kBenchmarkDecodeSteps = 32;
+    static constexpr int kBenchmarkIterations = 3;
+
+    ModelLease model(*this);
+    if (!isLoaded() || !model) {
+        AIDEO_LOGE(LOG_TAG_M2M100, "Model is not loaded");
+        return {};
+    }
+
+    EncoderDecoderWithPast::WarmUpConfig shape;
+    shape.encoderLength = kBenchmarkEncoderLength;
+    shape.decoderWithPastSteps = kBenchmarkDecodeSteps;
+    return model->decoder.benchmarkCrossAttention(shape, kBenchmarkIterations);
+}
+
+void M2M100Translator::setSessionMemoryBudget(int64_t budgetBytes) {
+    memoryBudgetBytes_.store(budgetBytes);
+    ModelLease model(*this);
+    if (model) {
+        model->decoder.setMemoryBudget(budgetBytes);
+    }
+}
+
+OnnxInference::SessionCacheStats M2M100Translator::sessionCacheStats() const {
+    ModelLease model(*this);
+    if (!model) {
+        OnnxInference::SessionCacheStats stats;
+        stats.memoryBudgetBytes = memoryBudgetBytes_.load();
+        return stats;
+    }
+    return model->decoder.sessionCacheStats();
+}
+
+bool M2M100Translator::startProfiling(const OnnxInference::ProfilingConfig& config) {
+    ModelLease model(*this);
+    if (!model) {
+        AIDEO_LOGE(LOG_TAG_M2M100, "Model is not loaded");
+        return false;
+    }
+    return model->decoder.startProfiling(config);
+}
+
+std::string M2M100Translator::profilingSummaryJson() const {
+    ModelLease model(*this);
+    return OrtProfileSummary::toJson(
+            model ? model->decoder.profilingSummaries() : std::vector<OrtProfileSummary>{});
+}
+
+std::string M2M100Translator::runStatsJson() const {
+    ModelLease model(*this);
+    return SessionRunStats::toJson(
+            model ? model->decoder.runStats() : std::vector<SessionRunStats>{});
+}
+
+void M2M100Translator::resetRunStats() {
+    ModelLease model(*this);
+    if (model) {
+        model->decoder.resetRunStats();
+    }
+}
+
+void M2M100Translator::cancel() {
+    std::lock_guard<std::mutex> lock(cancellationsMutex_);
+    for (auto& active: activeCancellations_) {
+        active.first->cancel();
+    }
+}
+
+void M2M100Translator::cancel(int64_t requestId) {
+    if (requestId == kNoRequestId) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(cancellationsMutex_);
+    bool cancelled = false;
+    for (auto& [cancellation, activeRequestId]: activeCancellations_) {
+        if (activeRequestId == requestId) {
+            cancellation->cancel();
+            cancelled = true;
+        }
+    }
+    if (cancelled) {
+        return;
+    }
+    // 번역 스레드가 아직 translate() 에 들어오지 않음 → 시작할 때 중단되도록 기록
+    // 이미 끝난 요청이었다면 남게 되므로 오래된 것부터 버림 (id 는 단조 증가)
+    pendingCancellations_.push_back(requestId);
+    if (pendingCancellations_.size() > kMaxPendingCancellations) {
+        pendingCancellations_.pop_front();
+    }
+}
+
 void M2M100Translator::release() {
-    decoder_.release();
-    tokenizer_.release();
-    languageTokens_.clear();
-    loadedTokenizerConfigPath_.clear();
+    // 새 번역이 시작되지 않도록 먼저 표시한 뒤, 진행 중인 번역이 끝나면 세트 해제
     Translator::release();
+    swapModelSet(nullptr);
 }
@@ -1,10 +1,21 @@
 #ifndef AIDEO_M2M100_TRANSLATOR_H
 #define AIDEO_M2M100_TRANSLATOR_H
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
+#include "cancellation_token.h"
 #include "encoder_decoder_with_past.h"
 #include "language_token_map.h"
 #include "logging.h"
+#include "model_variant_registry.h"
 #include "tokenizer.h"
 #include "translator.h"
 
@@ -18,7 +29,13 @@ public:
     // 소멸자는 반드시 override 된 Translator#release() 를 호출해야 함.
     ~M2M100Translator() override;
 
-    // 모델 및 토크나이저 로드 (JNI 시그니처 그대로 유지)
+    /**
+     * 모델 및 토크나이저 로드 (JNI 시그니처 그대로 유지)
+     *
+     * 이미 로드된 모델이 있으면 새 세트를 만드는 동안 기존 세트로 계속 번역하고,
+     * 준비가 끝나면 교체 후 기존 세트를 사용 중인 번역이 끝나기를 기다려 해제 (교체 중에는 두 세트가 함께 상주)
+     * 실패하면 기존 세트를 그대로 유지
+     */
     bool load(
             const char* encoderPath,
             const char* decoderPath,
@@ -28,6 +45,31 @@ public:
             const char* tokenizerConfigPath
     );
 
+    // decoder / decoder_with_past 대신 merged decoder 하나로 로드 (EncoderDecoderWithPast::loadMerged)
+    bool loadMerged(
+            const char* encoderPath,
+            const char* mergedDecoderPath,
+            const char* spModelPath,
+            const char* vocabPath,
+            const char* tokenizerConfigPath
+    );
+
+    /**
+     * [modelDirectory] 의 "<modelPrefix>_<role>.<variant>.onnx" variant 중 이 기기에서 가장 빠른 variant 로 로드
+     *
+     * 첫 실행에서는 모든 variant 를 측정해 [selectionPath] 에 저장하고, 이후에는 저장된 결과로 바로 선택
+     * 세션 메모리 예산(setSessionMemoryBudget)을 넘는 variant 는 제외
+     * @return 로드한 variant 이름, 실패 시 빈 문자열
+     */
+    std::string loadBestVariant(
+            const char* modelDirectory,
+            const char* modelPrefix,
+            const char* selectionPath,
+            const char* spModelPath,
+            const char* vocabPath,
+            const char* tokenizerConfigPath
+    );
+
     // Translator override — lang 코드 → 토큰 ID 변환 후 M2M100 입력을 구성해 번역.
     std::string translate(
             const std::string& text,
@@ -36,33 +78,194 @@ public:
             int maxLength = 256
     ) override;
 
-    // decoder_.release() + languageTokens_.clear() + Translator::release()
+    // requestId 없이 시작한 번역 — cancel(requestId) 로는 중단되지 않음
+    static constexpr int64_t kNoRequestId = 0;
+
+    /**
+     * cancel([requestId]) 로 중단 가능한 번역
+     *
+     * @param requestId : 호출 측이 요청마다 새로 발급한 id (kNoRequestId 가 아니어야 cancel(requestId) 대상)
+     */
+    std::string translate(
+            const std::string& text,
+            const std::string& srcLang,
+            const std::string& tgtLang,
+            int maxLength,
+            int64_t requestId
+    );
+
+    /**
+     * [cancellation] 으로 중단 가능한 번역
+     *
+     * cancellation 은 Session::Run 의 terminate flag 및 decode step 사이의 취소 확인에 사용
+     */
+    std::string translate(
+            const std::string& text,
+            const std::string& srcLang,
+            const std::string& tgtLang,
+            int maxLength,
+            const CancellationToken& cancellation
+    );
+
+    /**
+     * 호출 시점에 진행 중인 모든 translate(text, srcLang, tgtLang, maxLength[, requestId]) 의 Session::Run 을 즉시 중단시키고,
+     * 다음 decode step 으로 진행하지 않도록 함. 이후 시작하는 번역에는 영향 없음
+     */
+    void cancel() override;
+
+    /**
+     * [requestId] 번역만 중단
+     *
+     * 아직 translate() 가 시작되지 않았으면 기록해 두었다가, 그 id 로 시작하는 즉시 중단
+     * (이미 끝난 요청의 id 는 최근 kMaxPendingCancellations 개까지만 보관)
+     */
+    void cancel(int64_t requestId);
+
+    /**
+     * encoder / decoder / decoder_with_past (또는 merged decoder) 세션의 EP 구성 선택
+     *
+     * 다음 load() 부터 적용 (이미 로드된 세트는 load() 로 교체될 때 반영됨)
+     * @param xnnpackThreads : XNNPACK 자체 스레드 수 (0 이하면 기본값)
+     */
+    void setExecutionProvider(SessionProfile::ExecutionProvider provider, int xnnpackThreads = 0);
+
+    /**
+     * 토큰마다 실행되는 cached step 세션(decoder_with_past 또는 merged decoder)의 intra-op 워커 배치
+     *
+     * 다음 load() 부터 적용. encoder / decoder 는 global 스레드 풀을 쓰므로 대상이 아님
+     */
+    void setThreadAffinity(const ThreadAffinity& affinity);
+
+    /**
+     * cached step 세션을 [threadLevels] 스레드 수 단계별로 준비해 두고, step 시간에 따라 단계를 바꿔 가며 실행
+     *
+     * 다음 load() 부터 적용. [threadLevels] 가 비어 있으면 끔
+     */
+    void setAdaptiveThreading(const std::vector<int>& threadLevels);
+
+    struct ThreadAffinityBenchmark {
+        // cached step 1회 평균 (ms), 실패 시 음수
+        double unpinnedStepMs = -1.0;
+        double pinnedStepMs = -1.0;
+    };
+
+    /**
+     * 로드된 모델과 같은 경로로 측정용 인스턴스를 만들어, cached step 세션을 배치 없이 / [pinned] 배치로 각각 생성해 step 시간을 비교
+     *
+     * 번역 중인 세트는 건드리지 않으므로 측정 중에도 번역 가능 (측정하는 동안 모델이 한 벌 더 상주)
+     */
+    ThreadAffinityBenchmark benchmarkThreadAffinity(const ThreadAffinity& pinned);
+
+    /**
+     * 로드된 모델로 자막 한 줄 길이 문장의 cross-attention K/V 고정 크기와 step 당 절약 바이트 측정
+     *
+     * 세션을 다시 만들지 않으므로 측정 중에도 번역 가능. 로드 전이면 모든 값이 기본값
+     */
+    EncoderDecoderWithPast::CrossAttentionBenchmark benchmarkCrossAttention();
+
+    // ONNX 세션 메모리 예산. ASR 등 다른 모델이 메모리를 쓰는 동안 낮춰 두면 번역 세션이 축출됨
+    void setSessionMemoryBudget(int64_t budgetBytes);
+
+    OnnxInference::SessionCacheStats sessionCacheStats() const;
+
+    // 이후 번역들에서 세션별 op 실행 시간을 수집
+    bool startProfiling(const OnnxInference::ProfilingConfig& config);
+
+    // 세션별 상위 op 집계 JSON 배열 (OrtProfileSummary::toJson)
+    std::string profilingSummaryJson() const;
+
+    // 세션 키별 Run 시간/텐서 크기 통계 JSON 배열 (SessionRunStats::toJson)
+    std::string runStatsJson() const;
+
+    void resetRunStats();
+
+    // 진행 중인 번역이 끝나기를 기다린 뒤 모델 세트 해제 + Translator::release()
     void release() override;
 
 private:
-    bool loadLanguageTokens(const char* tokenizerConfigPath);
+    // load() 한 번으로 만들어지는 세션 + 토크나이저 묶음. 번역은 시작할 때의 세트를 끝까지 사용
+    struct ModelSet {
+        EncoderDecoderWithPast decoder;
+
+        // 파일 경로가 같으면 다음 세트와 공유 (로드 후에는 읽기만 함)
+        std::shared_ptr<Tokenizer> tokenizer;
+        // "ko" → 128022 등
+        std::shared_ptr<const LanguageTokenMap> languageTokens;
+
+        // M2M100 special token — encoder/decoder input 구성에 사용
+        // base 가 아닌 모델별로 보유 (모델마다 필요한 토큰이 다름).
+        int64_t eosTokenId = 2;
+        std::string spModelPath;
+        std::string vocabPath;
+        std::string tokenizerConfigPath;
+
+        // 이 세트를 사용 중인 ModelLease 수 (modelMutex_ 로 보호)
+        int activeRequests = 0;
+    };
+
+    // 현재 모델 세트 사용권 — 살아 있는 동안 교체된 세트가 해제되지 않음. 로드 전이면 비어 있음
+    class ModelLease {
+    public:
+        explicit ModelLease(const M2M100Translator& owner);
+
+        ~ModelLease();
+
+        ModelLease(const ModelLease&) = delete;
+
+        ModelLease& operator=(const ModelLease&) = delete;
+
+        explicit operator bool() const { return model_ != nullptr; }
+
+        ModelSet* operator->() const { return model_; }
+
+    private:
+        const M2M100Translator& owner_;
+        ModelSet* model_ = nullptr;
+    };
+
+    // [loadOnnxModels] 와 토크나이저, 언어 토큰 로드를 병렬 실행해 새 세트를 만들고 swapModelSet()
+    bool loadComponents(
+            const std::function<bool(EncoderDecoderWithPast&)>& loadOnnxModels,
+            const char* spModelPath,
+            const char* vocabPath,
+            const char* tokenizerConfigPath
+    );
+
+    // variant 하나를 로드해 짧은 generation 을 측정하고 해제
+    ModelVariantRegistry::Measurement benchmarkVariant(const ModelVariantRegistry::Variant& variant);
+
+    static bool loadLanguageTokens(const char* tokenizerConfigPath, LanguageTokenMap& languageTokens);
+
+    // 로드/측정 시작 시점의 loadOptions_ 복사본 — 진행 중에 setExecutionProvider() 등이 호출되어도 바뀌지 않음
+    EncoderDecoderWithPast::LoadOptions loadOptionsSnapshot() const;
+
+    // [next] 를 현재 세트로 바꾸고, 이전 세트를 사용 중인 번역이 모두 끝나면 해제
+    void swapModelSet(std::unique_ptr<ModelSet> next);
+
+    // 현재 모델 세트와 세트별 사용 수 보호. 교체 대기는 modelDrained_ 로
+    mutable std::mutex modelMutex_;
+    mutable std::condition_variable modelDrained_;
+    std::unique_ptr<ModelSet> model_;
+
+    // 새로 만드는 세트에도 적용하는 세션 메모리 예산 (JNI 스레드에서 쓰고 로드 스레드에서 읽음)
+    std::atomic<int64_t> memoryBudgetBytes_{ 0 };
 
-    EncoderDecoderWithPast decoder_;
+    // loadOptions_, cachedStepAffinity_ 보호. 로드/측정은 loadOptionsSnapshot() 으로 복사해 사용
+    mutable std::mutex settingsMutex_;
 
-    // SentencePiece + vocab.json — M2M100 입력/출력 토큰화
-    Tokenizer tokenizer_;
+    // decoder.load() 에 전달할 세션별 설정
+    EncoderDecoderWithPast::LoadOptions loadOptions_;
 
-    // "ko" → 128022 등
-    LanguageTokenMap languageTokens_;
+    // setExecutionProvider() 로 프로필을 다시 만들어도 유지
+    ThreadAffinity cachedStepAffinity_;
 
-    // M2M100 special token — encoder/decoder input 구성에 사용
-    // base 가 아닌 모델별로 보유 (모델마다 필요한 토큰이 다름).
-    int64_t eosTokenId_ = 2;
-    std::string loadedTokenizerConfigPath_;
+    static constexpr size_t kMaxPendingCancellations = 32;
 
-    // 모델 설정 (M2M100의 설정값, facebook/m2m100/config.json 에 명시된 학습할 때 결정된 값)
-    // layer 개수(decoder 의 반복 횟수)
-    static constexpr int NUM_DECODER_LAYERS = 12;
-    // attention(무엇을 얼마나 참고해야 하는가)에 대한 관점의 수 ==> 16개의 관점으로 self-attention(decoder 이전 출력), cross-attention(encoder 의 결과 == 원문) 을 참고
-    static constexpr int NUM_HEADS = 16;
-    // 각 토큰 벡터의 길이
-    static constexpr int HIDDEN_SIZE = 1024;
-    static constexpr int64_t VOCAB_SIZE = 128112;
+    // translate(text, srcLang, tgtLang, maxLength[, requestId]) 가 요청마다 만든 취소 핸들 → requestId
+    std::mutex cancellationsMutex_;
+    std::unordered_map<CancellationToken*, int64_t> activeCancellations_;
+    // 시작 전에 cancel(requestId) 된 id (오래된 순)
+    std::deque<int64_t> pendingCancellations_;
 };
 
 #endif
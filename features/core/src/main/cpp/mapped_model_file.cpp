@@ -0,0 +1,68 @@
+#include "mapped_model_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // 한 번에 너무 큰 범위를 madvise 하면 I/O 가 몰려 foreground 의 page fault 가 밀림 → 구간 단위로 나눠 요청
+    constexpr size_t kReadaheadChunkSize = 4 << 20;
+}
+
+std::unique_ptr<MappedModelFile> MappedModelFile::map(const char* path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        AIDEO_LOGE(LOG_TAG_MAPPED_MODEL, "Failed to open %s: %s", path, strerror(errno));
+        return nullptr;
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+        AIDEO_LOGE(LOG_TAG_MAPPED_MODEL, "Failed to stat %s", path);
+        close(fd);
+        return nullptr;
+    }
+
+    auto size = static_cast<size_t>(fileStat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // 매핑은 fd 와 무관하게 유지됨
+    close(fd);
+    if (data == MAP_FAILED) {
+        AIDEO_LOGE(LOG_TAG_MAPPED_MODEL, "Failed to mmap %s: %s", path, strerror(errno));
+        return nullptr;
+    }
+
+    return std::unique_ptr<MappedModelFile>(new MappedModelFile(data, size));
+}
+
+MappedModelFile::MappedModelFile(void* data, size_t size) : data_(data), size_(size) {}
+
+MappedModelFile::~MappedModelFile() {
+    stopReadahead_.store(true, std::memory_order_relaxed);
+    if (readaheadThread_.joinable()) {
+        readaheadThread_.join();
+    }
+    munmap(data_, size_);
+}
+
+void MappedModelFile::startReadahead() {
+    if (readaheadThread_.joinable()) {
+        return;
+    }
+
+    readaheadThread_ = std::thread([this]() {
+        auto* base = static_cast<char*>(data_);
+        for (size_t offset = 0;
+             offset < size_ && !stopReadahead_.load(std::memory_order_relaxed);
+             offset += kReadaheadChunkSize) {
+            size_t length = std::min(kReadaheadChunkSize, size_ - offset);
+            if (madvise(base + offset, length, MADV_WILLNEED) != 0) {
+                AIDEO_LOGW(LOG_TAG_MAPPED_MODEL, "madvise(WILLNEED) failed: %s", strerror(errno));
+                return;
+            }
+        }
+    });
+}
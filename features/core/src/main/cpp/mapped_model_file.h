@@ -0,0 +1,44 @@
+#ifndef AIDEO_MAPPED_MODEL_FILE_H
+#define AIDEO_MAPPED_MODEL_FILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include "logging.h"
+
+#define LOG_TAG_MAPPED_MODEL "MappedModelFile"
+
+// 모델 파일 전체를 read-only 로 mmap 한 영역
+// ORT 세션이 이 영역을 직접 참조(session.use_ort_model_bytes_directly)하는 동안에는 해제되면 안 됨
+class MappedModelFile {
+public:
+    /**
+     * @param path : 모델 파일 경로
+     * @return 실패 시 nullptr
+     */
+    static std::unique_ptr<MappedModelFile> map(const char* path);
+
+    ~MappedModelFile();
+
+    MappedModelFile(const MappedModelFile&) = delete;
+
+    MappedModelFile& operator=(const MappedModelFile&) = delete;
+
+    const void* data() const { return data_; }
+
+    size_t size() const { return size_; }
+
+    // 백그라운드 스레드에서 madvise(MADV_WILLNEED) 로 page cache 를 미리 채움 → 첫 Run 의 page fault 감소
+    void startReadahead();
+
+private:
+    MappedModelFile(void* data, size_t size);
+
+    void* data_;
+    size_t size_;
+    std::atomic<bool> stopReadahead_{ false };
+    std::thread readaheadThread_;
+};
+
+#endif
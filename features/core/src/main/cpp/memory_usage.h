@@ -0,0 +1,29 @@
+#ifndef AIDEO_MEMORY_USAGE_H
+#define AIDEO_MEMORY_USAGE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <unistd.h>
+
+namespace aideo {
+
+    // 현재 프로세스의 RSS(bytes). 읽기 실패 시 0
+    inline int64_t residentSetBytes() {
+        FILE* statm = std::fopen("/proc/self/statm", "r");
+        if (statm == nullptr) {
+            return 0;
+        }
+
+        long long totalPages = 0;
+        long long residentPages = 0;
+        int matched = std::fscanf(statm, "%lld %lld", &totalPages, &residentPages);
+        std::fclose(statm);
+        if (matched != 2) {
+            return 0;
+        }
+        return static_cast<int64_t>(residentPages) * sysconf(_SC_PAGESIZE);
+    }
+
+}
+
+#endif
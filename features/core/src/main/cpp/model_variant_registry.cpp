@@ -0,0 +1,215 @@
+#include "model_variant_registry.h"
+#include "json.hpp"
+#include "onnxruntime_cxx_api.h"
+#include "path_utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <dirent.h>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <utility>
+
+using json = nlohmann::json;
+
+namespace {
+    constexpr const char* kOnnxExtension = ".onnx";
+
+    bool endsWith(const std::string& value, const std::string& suffix) {
+        return value.size() >= suffix.size() &&
+               value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+size_t ModelVariantRegistry::discover(const std::string& modelDirectory, const std::string& modelPrefix) {
+    variants_.clear();
+
+    DIR* directory = opendir(modelDirectory.c_str());
+    if (directory == nullptr) {
+        AIDEO_LOGE(LOG_TAG_MODEL_VARIANT, "Failed to open model directory: %s", modelDirectory.c_str());
+        return 0;
+    }
+
+    // variant 이름 순으로 정렬된 상태로 모음
+    std::map<std::string, Variant> variantsByName;
+    const std::string filePrefix = modelPrefix + "_";
+    while (dirent* entry = readdir(directory)) {
+        std::string fileName(entry->d_name);
+        if (fileName.compare(0, filePrefix.size(), filePrefix) != 0 || !endsWith(fileName, kOnnxExtension)) {
+            continue;
+        }
+
+        // "<prefix>_decoder_with_past.int8.onnx" → role = "decoder_with_past", variant = "int8"
+        std::string stem = fileName.substr(
+                filePrefix.size(), fileName.size() - filePrefix.size() - std::string(kOnnxExtension).size());
+        auto dot = stem.rfind('.');
+        if (dot == std::string::npos || dot == 0 || dot + 1 == stem.size()) {
+            continue;
+        }
+        std::string role = stem.substr(0, dot);
+        std::string variantName = stem.substr(dot + 1);
+        std::string path = modelDirectory + "/" + fileName;
+
+        auto& variant = variantsByName[variantName];
+        variant.name = variantName;
+        if (role == "encoder") {
+            variant.encoderPath = std::move(path);
+        } else if (role == "decoder") {
+            variant.decoderPath = std::move(path);
+        } else if (role == "decoder_with_past") {
+            variant.decoderWithPastPath = std::move(path);
+        } else if (role == "decoder_merged") {
+            variant.mergedDecoderPath = std::move(path);
+        }
+    }
+    closedir(directory);
+
+    for (auto& [variantName, variant]: variantsByName) {
+        if (!variant.isComplete()) {
+            AIDEO_LOGW(LOG_TAG_MODEL_VARIANT, "Skipping incomplete variant: %s", variantName.c_str());
+            continue;
+        }
+        AIDEO_LOGI(LOG_TAG_MODEL_VARIANT, "Found variant %s (%s decoder)",
+                   variantName.c_str(), variant.usesMergedDecoder() ? "merged" : "split");
+        variants_.push_back(std::move(variant));
+    }
+    return variants_.size();
+}
+
+const ModelVariantRegistry::Variant* ModelVariantRegistry::select(
+        const std::string& selectionPath,
+        int64_t memoryBudgetBytes,
+        const Benchmark& benchmark) {
+    if (variants_.empty()) {
+        return nullptr;
+    }
+
+    std::string currentFingerprint = fingerprint();
+    std::vector<Measurement> measurements;
+    if (!loadMeasurements(selectionPath, currentFingerprint, measurements)) {
+        for (const auto& variant: variants_) {
+            AIDEO_LOGI(LOG_TAG_MODEL_VARIANT, "Benchmarking variant %s", variant.name.c_str());
+            Measurement measurement = benchmark(variant);
+            measurement.variantName = variant.name;
+            if (measurement.succeeded) {
+                AIDEO_LOGI(LOG_TAG_MODEL_VARIANT, "  %s: %.1f ms, %lld KiB",
+                           variant.name.c_str(), measurement.generationMs,
+                           static_cast<long long>(measurement.residentBytes / 1024));
+            } else {
+                AIDEO_LOGW(LOG_TAG_MODEL_VARIANT, "  %s: benchmark failed", variant.name.c_str());
+            }
+            measurements.push_back(std::move(measurement));
+        }
+        storeMeasurements(selectionPath, currentFingerprint, measurements);
+    }
+
+    const Measurement* fastest = nullptr;
+    const Measurement* smallest = nullptr;
+    for (const auto& measurement: measurements) {
+        if (!measurement.succeeded) {
+            continue;
+        }
+        if (smallest == nullptr || measurement.residentBytes < smallest->residentBytes) {
+            smallest = &measurement;
+        }
+        bool fitsBudget = memoryBudgetBytes <= 0 || measurement.residentBytes <= memoryBudgetBytes;
+        if (fitsBudget && (fastest == nullptr || measurement.generationMs < fastest->generationMs)) {
+            fastest = &measurement;
+        }
+    }
+
+    const Measurement* chosen = fastest != nullptr ? fastest : smallest;
+    if (chosen == nullptr) {
+        AIDEO_LOGE(LOG_TAG_MODEL_VARIANT, "No usable model variant");
+        return nullptr;
+    }
+    if (fastest == nullptr) {
+        AIDEO_LOGW(LOG_TAG_MODEL_VARIANT, "No variant fits %lld KiB budget, using smallest",
+                   static_cast<long long>(memoryBudgetBytes / 1024));
+    }
+
+    auto variant = std::find_if(variants_.begin(), variants_.end(), [chosen](const Variant& item) {
+        return item.name == chosen->variantName;
+    });
+    if (variant == variants_.end()) {
+        return nullptr;
+    }
+    AIDEO_LOGI(LOG_TAG_MODEL_VARIANT, "Selected variant %s", variant->name.c_str());
+    return &*variant;
+}
+
+std::string ModelVariantRegistry::fingerprint() const {
+    std::string fingerprint = std::string("ort=") + Ort::GetVersionString();
+    for (const auto& variant: variants_) {
+        fingerprint += "|" + variant.name;
+        for (const auto* path: { &variant.encoderPath, &variant.decoderPath,
+                                 &variant.decoderWithPastPath, &variant.mergedDecoderPath }) {
+            fingerprint += ":" + std::to_string(aideo::fileSizeBytes(path->c_str()));
+        }
+    }
+    return fingerprint;
+}
+
+bool ModelVariantRegistry::loadMeasurements(
+        const std::string& selectionPath,
+        const std::string& fingerprint,
+        std::vector<Measurement>& measurements) const {
+    std::ifstream file(selectionPath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    try {
+        json stored = json::parse(file);
+        if (stored.value("fingerprint", "") != fingerprint || !stored["measurements"].is_array()) {
+            AIDEO_LOGI(LOG_TAG_MODEL_VARIANT, "Stored variant benchmark is stale");
+            return false;
+        }
+
+        std::vector<Measurement> loaded;
+        for (const auto& item: stored["measurements"]) {
+            Measurement measurement;
+            measurement.variantName = item.value("variant", "");
+            measurement.succeeded = item.value("succeeded", false);
+            measurement.generationMs = item.value("generationMs", 0.0);
+            measurement.residentBytes = item.value("residentBytes", static_cast<int64_t>(0));
+            loaded.push_back(std::move(measurement));
+        }
+        measurements = std::move(loaded);
+        return true;
+    } catch (const std::exception& e) {
+        AIDEO_LOGW(LOG_TAG_MODEL_VARIANT, "Failed to read variant benchmark: %s", e.what());
+        return false;
+    }
+}
+
+void ModelVariantRegistry::storeMeasurements(
+        const std::string& selectionPath,
+        const std::string& fingerprint,
+        const std::vector<Measurement>& measurements) const {
+    json stored;
+    stored["fingerprint"] = fingerprint;
+    stored["measurements"] = json::array();
+    for (const auto& measurement: measurements) {
+        stored["measurements"].push_back({
+                { "variant", measurement.variantName },
+                { "succeeded", measurement.succeeded },
+                { "generationMs", measurement.generationMs },
+                { "residentBytes", measurement.residentBytes },
+        });
+    }
+
+    // 기록 도중 종료되어도 이전 결과가 깨지지 않도록 임시 파일에 쓴 뒤 교체
+    std::string pendingPath = selectionPath + ".tmp";
+    {
+        std::ofstream file(pendingPath, std::ios::trunc);
+        if (!file.is_open() || !(file << stored.dump())) {
+            AIDEO_LOGW(LOG_TAG_MODEL_VARIANT, "Failed to write variant benchmark: %s", selectionPath.c_str());
+            std::remove(pendingPath.c_str());
+            return;
+        }
+    }
+    if (std::rename(pendingPath.c_str(), selectionPath.c_str()) != 0) {
+        std::remove(pendingPath.c_str());
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef AIDEO_MODEL_VARIANT_REGISTRY_H
+#define AIDEO_MODEL_VARIANT_REGISTRY_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "logging.h"
+
+#define LOG_TAG_MODEL_VARIANT "ModelVariantRegistry"
+
+// 같은 모델의 가중치 형식별 파일 묶음(fp16 / int8 / int4 ...)을 관리하고, 기기에서 측정한 결과로 사용할 variant 를 선택
+//   - 측정 결과는 JSON 으로 저장해 다음 실행부터는 측정 없이 선택
+//   - variant 구성(파일 크기)이나 ORT 버전이 바뀌면 저장된 결과는 무효 처리되고 다시 측정
+class ModelVariantRegistry {
+public:
+    // 역할별 모델 경로. 비어 있으면 해당 역할의 파일 없음
+    struct Variant {
+        // 파일 이름의 형식 부분 (예: "int8")
+        std::string name;
+        std::string encoderPath;
+        std::string decoderPath;
+        std::string decoderWithPastPath;
+        std::string mergedDecoderPath;
+
+        // merged decoder 가 있으면 분리형 decoder 보다 우선
+        bool usesMergedDecoder() const { return !mergedDecoderPath.empty(); }
+
+        bool isComplete() const {
+            return !encoderPath.empty() &&
+                   (usesMergedDecoder() || (!decoderPath.empty() && !decoderWithPastPath.empty()));
+        }
+    };
+
+    struct Measurement {
+        std::string variantName;
+        bool succeeded = false;
+        // encoder 1회 + decode N step 평균 소요 시간
+        double generationMs = 0.0;
+        // 로드된 세션들의 추정 메모리 사용량
+        int64_t residentBytes = 0;
+    };
+
+    // variant 를 로드해 측정하고, 측정 후에는 해제해야 함
+    using Benchmark = std::function<Measurement(const Variant&)>;
+
+    /**
+     * [modelDirectory] 에서 "<modelPrefix>_<role>.<variant>.onnx" 파일을 찾아 variant 별로 묶음
+     *
+     * role : encoder, decoder, decoder_with_past, decoder_merged. 필요한 역할이 모두 있는 variant 만 등록
+     * @return 등록된 variant 수
+     */
+    size_t discover(const std::string& modelDirectory, const std::string& modelPrefix);
+
+    const std::vector<Variant>& variants() const { return variants_; }
+
+    /**
+     * 가장 빠르면서 [memoryBudgetBytes] 안에 들어가는 variant 선택
+     *
+     * [selectionPath] 에 저장된 측정 결과가 현재 variant 구성과 일치하면 재사용하고, 아니면 모든 variant 를 [benchmark] 로 측정해 저장
+     * @param memoryBudgetBytes : 0 이하면 제한 없음. 모든 variant 가 초과하면 가장 작은 variant
+     * @return 선택된 variant. 측정에 모두 실패하면 nullptr
+     */
+    const Variant* select(
+            const std::string& selectionPath,
+            int64_t memoryBudgetBytes,
+            const Benchmark& benchmark
+    );
+
+private:
+    // ORT 버전 + variant 별 파일 크기
+    std::string fingerprint() const;
+
+    bool loadMeasurements(
+            const std::string& selectionPath,
+            const std::string& fingerprint,
+            std::vector<Measurement>& measurements
+    ) const;
+
+    void storeMeasurements(
+            const std::string& selectionPath,
+            const std::string& fingerprint,
+            const std::vector<Measurement>& measurements
+    ) const;
+
+    std::vector<Variant> variants_;
+};
+
+#endif
@@ -1,83 +1,797 @@
 #include "onnxruntime_inference.h"
+#include "onnxruntime_session_options_config_keys.h"
+#include "memory_usage.h"
 #include "path_utils.h"
 #include <algorithm>
+#include <cerrno>
 #include <thread>
 #include <utility>
+#include <sys/stat.h>
+#include <unistd.h>
 
-OnnxInference::OnnxInference()
-        : env_(ORT_LOGGING_LEVEL_WARNING, "OnnxInference") {
-    // 모바일 최적화: 메모리 Arena 비활성화로 버벅임 해결됨
-    // 스레드 수는 성능을 위해 적정 수준 유지 (코어의 절반, 2~4개)
-    unsigned int totalCores = std::thread::hardware_concurrency();
-    unsigned int numThreads = std::min(4u, std::max(2u, totalCores / 2));
-    if (totalCores == 0) numThreads = 2;  // 감지 실패 시 기본값
+OnnxInference::OnnxInference() : OnnxInference(ThreadingConfig{}) {}
 
-    // 세션 옵션 설정
-    // TODO : JVM 스레드 수와 연동되나? 만약 그렇다면, 스레드 수가 너무 많은 건 좋지 않음.
-    sessionOptions_.SetIntraOpNumThreads(
-            static_cast<int>(numThreads)); // 하나의 샘플에 대해 병렬 연산할 수 있을 때, 몇개의 스레드로 실행할 것 인지
-    sessionOptions_.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+OnnxInference::OnnxInference(const ThreadingConfig& threadingConfig)
+        : threadPoolMode_(threadingConfig.mode),
+          intraOpThreads_(threadingConfig.intraOpThreads > 0
+                          ? threadingConfig.intraOpThreads
+                          : defaultIntraOpThreads()),
+          env_(createEnv(threadingConfig)),
+          prepackedWeightsContainer_(createPrepackedWeightsContainer()) {}
 
-    // 메모리 최적화: Arena allocator 비활성화
-    // Arena는 메모리를 미리 할당하고 해제를 지연시켜 메모리 사용량 증가
-    // 비활성화하면 즉시 해제되어 메모리 사용량 감소
-    sessionOptions_.DisableCpuMemArena();
+OnnxInference::~OnnxInference() = default;
 
-    // 메모리 패턴 최적화 활성화
-    // 실행 중 메모리 할당 패턴을 분석하여 재사용
-    sessionOptions_.EnableMemPattern();
+Ort::Session* OnnxInference::SessionLease::get() const {
+    return loaded_ ? loaded_->session.get() : nullptr;
 }
 
-OnnxInference::~OnnxInference() = default;
-
 bool OnnxInference::loadSession(
         const std::string& sessionKey,
         const char* modelPath,
-        const char* modelName) {
+        const char* modelName,
+        const SessionProfile& profile) {
     if (sessionKey.empty()) {
         AIDEO_LOGE(LOG_TAG_ONNX, "Invalid session key for %s", modelName);
         return false;
     }
 
-    auto session = createSession(modelPath, modelName);
-    if (!session) {
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        ++sessionsInCreation_;
     }
+    auto entry = buildSessionEntry(modelPath, modelName, profile);
 
-    sessions_[sessionKey] = std::move(session);
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    --sessionsInCreation_;
+    if (!entry.loaded) {
+        return false;
+    }
+    entry.lastUsed = std::chrono::steady_clock::now();
+    // 같은 키로 다시 등록(예: 설정을 바꾼 재생성)해도 Run 통계는 이어서 기록
+    auto existing = sessions_.find(sessionKey);
+    entry.runStats = existing != sessions_.end() ? existing->second.runStats
+                                                 : std::make_shared<RunStatsSlot>();
+    entry.loaded->runStats = entry.runStats;
+    sessions_[sessionKey] = std::move(entry);
+    updateProfilingSessionsLocked();
+    enforceMemoryBudgetLocked(sessionKey);
     return true;
 }
 
 bool OnnxInference::hasSession(const std::string& sessionKey) const {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    return sessions_.find(sessionKey) != sessions_.end();
+}
+
+std::string OnnxInference::ortModelPath(const std::string& sessionKey) const {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
     auto session = sessions_.find(sessionKey);
-    return session != sessions_.end() && session->second != nullptr;
+    return session != sessions_.end() ? session->second.ortModelPath : std::string();
 }
 
-Ort::Session* OnnxInference::getSession(const std::string& sessionKey, const char* modelName) {
+OnnxInference::SessionLease OnnxInference::getSession(
+        const std::string& sessionKey,
+        const char* modelName) {
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        auto session = sessions_.find(sessionKey);
+        if (session == sessions_.end()) {
+            AIDEO_LOGE(LOG_TAG_ONNX, "%s session not loaded", modelName);
+            return nullptr;
+        }
+        auto& entry = session->second;
+        if (entry.loaded && entry.profilingPending && entry.loaded.use_count() == 1) {
+            // profiling 을 켠 세션으로 교체
+            entry.loaded.reset();
+        }
+        if (entry.loaded) {
+            ++cacheHits_;
+            entry.lastUsed = std::chrono::steady_clock::now();
+            return SessionLease(entry.loaded);
+        }
+    }
+
+    // 축출된 세션 재로드. 대기하는 동안 다른 스레드가 먼저 재로드했을 수 있으므로 다시 확인
+    std::lock_guard<std::mutex> reloadLock(reloadMutex_);
+    std::string modelPath;
+    SessionProfile profile;
+    bool forProfiling = false;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        auto session = sessions_.find(sessionKey);
+        if (session == sessions_.end()) {
+            AIDEO_LOGE(LOG_TAG_ONNX, "%s session not loaded", modelName);
+            return nullptr;
+        }
+        auto& entry = session->second;
+        if (entry.loaded) {
+            ++cacheHits_;
+            entry.lastUsed = std::chrono::steady_clock::now();
+            return SessionLease(entry.loaded);
+        }
+        ++sessionsInCreation_;
+        modelPath = entry.modelPath;
+        profile = entry.profile;
+        forProfiling = entry.profilingPending;
+        if (forProfiling) {
+            profile = profile.withProfiling(profilingConfig_.outputDirectory + "/" + sessionKey);
+        } else {
+            ++cacheMisses_;
+        }
+    }
+
+    AIDEO_LOGI(LOG_TAG_ONNX, forProfiling ? "Recreating %s session with profiling"
+                                         : "Reloading evicted %s session", modelName);
+    auto reloaded = buildSessionEntry(modelPath.c_str(), modelName, profile);
+
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    --sessionsInCreation_;
     auto session = sessions_.find(sessionKey);
-    if (session == sessions_.end() || !session->second) {
-        AIDEO_LOGE(LOG_TAG_ONNX, "%s session not loaded", modelName);
+    if (session == sessions_.end() || !reloaded.loaded) {
+        // 재로드 중 release() 되었거나 로드 실패
+        AIDEO_LOGE(LOG_TAG_ONNX, "Failed to reload %s session", modelName);
         return nullptr;
     }
-    return session->second.get();
+    auto& entry = session->second;
+    entry.loaded = std::move(reloaded.loaded);
+    entry.loaded->runStats = entry.runStats;
+    entry.ortModelPath = reloaded.ortModelPath;
+    entry.residentBytesDelta = reloaded.residentBytesDelta;
+    entry.estimatedBytes = reloaded.estimatedBytes;
+    entry.lastUsed = std::chrono::steady_clock::now();
+    if (forProfiling) {
+        entry.profilingPending = false;
+        entry.profiling = true;
+        entry.profiledRuns = 0;
+    }
+
+    SessionLease lease(entry.loaded);
+    enforceMemoryBudgetLocked(sessionKey);
+    return lease;
+}
+
+std::vector<Ort::Value> OnnxInference::run(
+        const std::string& sessionKey,
+        const SessionLease& session,
+        const Ort::RunOptions& runOptions,
+        const char* const* inputNames,
+        const Ort::Value* inputValues,
+        size_t inputCount,
+        const char* const* outputNames,
+        size_t outputCount) {
+    auto startedAt = std::chrono::steady_clock::now();
+    auto outputs = session->Run(
+            runOptions, inputNames, inputValues, inputCount, outputNames, outputCount);
+    auto elapsed = std::chrono::steady_clock::now() - startedAt;
+    onRunCompleted(sessionKey, session,
+                   std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+                   tensorBytes(inputValues, inputCount), tensorBytes(outputs.data(), outputs.size()));
+    return outputs;
+}
+
+void OnnxInference::run(
+        const std::string& sessionKey,
+        const SessionLease& session,
+        const Ort::RunOptions& runOptions,
+        const char* const* inputNames,
+        const Ort::Value* inputValues,
+        size_t inputCount,
+        const char* const* outputNames,
+        Ort::Value* outputValues,
+        size_t outputCount) {
+    auto startedAt = std::chrono::steady_clock::now();
+    session->Run(
+            runOptions, inputNames, inputValues, inputCount, outputNames, outputValues, outputCount);
+    auto elapsed = std::chrono::steady_clock::now() - startedAt;
+    onRunCompleted(sessionKey, session,
+                   std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+                   tensorBytes(inputValues, inputCount), tensorBytes(outputValues, outputCount));
+}
+
+void OnnxInference::run(
+        const std::string& sessionKey,
+        const SessionLease& session,
+        const Ort::RunOptions& runOptions,
+        Ort::IoBinding& ioBinding,
+        int64_t inputBytes,
+        int64_t outputBytes) {
+    auto startedAt = std::chrono::steady_clock::now();
+    session->Run(runOptions, ioBinding);
+    auto elapsed = std::chrono::steady_clock::now() - startedAt;
+    onRunCompleted(sessionKey, session,
+                   std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+                   inputBytes, outputBytes);
+}
+
+int64_t OnnxInference::tensorBytes(const Ort::Value* values, size_t count) {
+    int64_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!values[i] || !values[i].IsTensor()) {
+            continue;
+        }
+        auto tensorInfo = values[i].GetTensorTypeAndShapeInfo();
+        size_t elementBytes;
+        switch (tensorInfo.GetElementType()) {
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+                elementBytes = 8;
+                break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+                elementBytes = 2;
+                break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+                elementBytes = 1;
+                break;
+            default:
+                elementBytes = 4;
+                break;
+        }
+        bytes += static_cast<int64_t>(tensorInfo.GetElementCount() * elementBytes);
+    }
+    return bytes;
+}
+
+std::vector<SessionRunStats> OnnxInference::runStats() const {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    std::vector<SessionRunStats> stats;
+    stats.reserve(sessions_.size());
+    for (const auto& [sessionKey, entry]: sessions_) {
+        std::lock_guard<std::mutex> statsLock(entry.runStats->mutex);
+        auto snapshot = entry.runStats->recorder.snapshot(sessionKey);
+        // 등록만 되고 Run 하지 않은 세션은 제외
+        if (snapshot.runs > 0) {
+            stats.push_back(std::move(snapshot));
+        }
+    }
+    std::sort(stats.begin(), stats.end(), [](const SessionRunStats& a, const SessionRunStats& b) {
+        return a.sessionKey < b.sessionKey;
+    });
+    return stats;
+}
+
+void OnnxInference::resetRunStats() {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    for (auto& [sessionKey, entry]: sessions_) {
+        std::lock_guard<std::mutex> statsLock(entry.runStats->mutex);
+        entry.runStats->recorder = SessionRunStatsRecorder{};
+    }
+}
+
+void OnnxInference::onRunCompleted(
+        const std::string& sessionKey,
+        const SessionLease& session,
+        int64_t elapsedMicros,
+        int64_t inputBytes,
+        int64_t outputBytes) {
+    {
+        // 같은 세션을 동시에 Run 하는 요청끼리만 경쟁 — 세션 목록 잠금과 키 조회 없음
+        auto& runStats = *session.loaded_->runStats;
+        std::lock_guard<std::mutex> lock(runStats.mutex);
+        runStats.recorder.record(elapsedMicros, inputBytes, outputBytes);
+    }
+
+    // profiling 중인 세션이 없으면 (평상시) 세션 잠금 없이 끝냄
+    if (profilingSessions_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+
+    OrtProfileSummary summary;
+    int topOpCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        auto entry = sessions_.find(sessionKey);
+        if (entry == sessions_.end() || !entry->second.profiling) {
+            return;
+        }
+        if (++entry->second.profiledRuns < profilingConfig_.maxRuns) {
+            return;
+        }
+        entry->second.profiling = false;
+        updateProfilingSessionsLocked();
+        summary.sessionKey = sessionKey;
+        summary.runs = entry->second.profiledRuns;
+        topOpCount = profilingConfig_.topOpCount;
+    }
+
+    // trace 기록과 파싱은 수 MB 의 파일 I/O → 세션 잠금 밖에서 수행
+    std::string profilePath;
+    try {
+        Ort::AllocatorWithDefaultOptions allocator;
+        profilePath = session->EndProfilingAllocated(allocator).get();
+    } catch (const Ort::Exception& e) {
+        AIDEO_LOGE(LOG_TAG_ONNX, "Failed to end profiling of %s: %s", sessionKey.c_str(), e.what());
+        return;
+    }
+
+    if (!OrtProfileSummary::parse(profilePath, topOpCount, summary)) {
+        return;
+    }
+
+    AIDEO_LOGI(LOG_TAG_ONNX, "Profiled %s: %d runs, %lld us in kernels (%s)",
+               sessionKey.c_str(), summary.runs,
+               static_cast<long long>(summary.totalKernelMicros), profilePath.c_str());
+    for (const auto& op: summary.topOps) {
+        AIDEO_LOGI(LOG_TAG_ONNX, "  %-24s %10lld us %6lld calls",
+                   op.opType.c_str(), static_cast<long long>(op.totalMicros),
+                   static_cast<long long>(op.calls));
+    }
+    for (const auto& provider: summary.providers) {
+        AIDEO_LOGI(LOG_TAG_ONNX, "  %-24s %6lld nodes %10lld us",
+                   provider.provider.c_str(), static_cast<long long>(provider.nodes),
+                   static_cast<long long>(provider.totalMicros));
+    }
+
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    auto existing = std::find_if(
+            profilingSummaries_.begin(), profilingSummaries_.end(),
+            [&sessionKey](const OrtProfileSummary& item) { return item.sessionKey == sessionKey; });
+    if (existing != profilingSummaries_.end()) {
+        *existing = std::move(summary);
+    } else {
+        profilingSummaries_.push_back(std::move(summary));
+    }
+}
+
+bool OnnxInference::startProfiling(const ProfilingConfig& config) {
+    if (config.outputDirectory.empty() || config.maxRuns <= 0) {
+        AIDEO_LOGE(LOG_TAG_ONNX, "Invalid profiling config");
+        return false;
+    }
+    if (mkdir(config.outputDirectory.c_str(), 0700) != 0 && errno != EEXIST) {
+        AIDEO_LOGE(LOG_TAG_ONNX, "Failed to create profiling directory %s", config.outputDirectory.c_str());
+        return false;
+    }
+    if (access(config.outputDirectory.c_str(), W_OK) != 0) {
+        AIDEO_LOGE(LOG_TAG_ONNX, "Profiling directory %s is not writable", config.outputDirectory.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    profilingConfig_ = config;
+    profilingSummaries_.clear();
+    for (auto& [sessionKey, entry]: sessions_) {
+        entry.profilingPending = true;
+        entry.profiling = false;
+        // 사용 중이 아니면 바로 내려 두고, 다음 getSession() 에서 profiling 세션으로 생성
+        if (entry.loaded && entry.loaded.use_count() == 1) {
+            entry.loaded.reset();
+        }
+    }
+    updateProfilingSessionsLocked();
+    AIDEO_LOGI(LOG_TAG_ONNX, "Profiling %zu sessions for %d runs each",
+               sessions_.size(), config.maxRuns);
+    return true;
+}
+
+std::vector<OrtProfileSummary> OnnxInference::profilingSummaries() const {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    return profilingSummaries_;
+}
+
+void OnnxInference::setMemoryBudget(int64_t budgetBytes) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    memoryBudgetBytes_ = std::max<int64_t>(0, budgetBytes);
+    AIDEO_LOGI(LOG_TAG_ONNX, "Session memory budget: %lld KiB",
+               static_cast<long long>(memoryBudgetBytes_ / 1024));
+    enforceMemoryBudgetLocked(std::string());
+}
+
+OnnxInference::SessionCacheStats OnnxInference::sessionCacheStats() const {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    SessionCacheStats stats;
+    stats.hits = cacheHits_;
+    stats.misses = cacheMisses_;
+    stats.evictions = cacheEvictions_;
+    stats.memoryBudgetBytes = memoryBudgetBytes_;
+    stats.registeredSessions = static_cast<int>(sessions_.size());
+    for (const auto& [sessionKey, entry]: sessions_) {
+        if (entry.loaded) {
+            stats.residentBytes += entry.estimatedBytes;
+            ++stats.residentSessions;
+        }
+    }
+    return stats;
+}
+
+OnnxInference::SessionEntry OnnxInference::buildSessionEntry(
+        const char* modelPath,
+        const char* modelName,
+        const SessionProfile& profile) {
+    SessionEntry entry;
+    int64_t residentBytesBefore = aideo::residentSetBytes();
+    auto loaded = createSession(modelPath, modelName, profile);
+    if (!loaded.session) {
+        return entry;
+    }
+    // 생성 중에는 저장소가 교체되지 않으므로(sessionsInCreation_) 세션이 사용한 저장소와 같음
+    if (profile.sharePrepackedWeights) {
+        loaded.prepackedWeights = prepackedWeightsContainer_;
+    }
+    entry.residentBytesDelta = aideo::residentSetBytes() - residentBytesBefore;
+    // 병렬 로드 중에는 RSS 차이가 다른 세션의 해제/증가와 섞여 0 이하가 될 수 있음 → 모델 파일 크기로 대체
+    entry.estimatedBytes = entry.residentBytesDelta > 0
+                           ? entry.residentBytesDelta
+                           : aideo::fileSizeBytes(modelPath);
+    entry.ortModelPath = loaded.ortModelPath;
+    entry.loaded = std::make_shared<LoadedSession>(std::move(loaded));
+    entry.modelPath = modelPath;
+    entry.modelName = modelName;
+    entry.profile = profile;
+    return entry;
+}
+
+void OnnxInference::enforceMemoryBudgetLocked(const std::string& protectedSessionKey) {
+    if (memoryBudgetBytes_ <= 0) {
+        return;
+    }
+
+    int64_t residentBytes = 0;
+    for (const auto& [sessionKey, entry]: sessions_) {
+        if (entry.loaded) {
+            residentBytes += entry.estimatedBytes;
+        }
+    }
+
+    bool evictedSharedSession = false;
+    while (residentBytes > memoryBudgetBytes_) {
+        // 사용 중(lease 보유)이 아닌 세션 중 가장 오래전에 사용한 세션
+        SessionEntry* victim = nullptr;
+        const std::string* victimKey = nullptr;
+        for (auto& [sessionKey, entry]: sessions_) {
+            if (!entry.loaded || entry.loaded.use_count() > 1 || sessionKey == protectedSessionKey) {
+                continue;
+            }
+            if (victim == nullptr || entry.lastUsed < victim->lastUsed) {
+                victim = &entry;
+                victimKey = &sessionKey;
+            }
+        }
+
+        if (victim == nullptr) {
+            AIDEO_LOGW(LOG_TAG_ONNX, "Session memory over budget (%lld / %lld KiB), no idle session",
+                       static_cast<long long>(residentBytes / 1024),
+                       static_cast<long long>(memoryBudgetBytes_ / 1024));
+            break;
+        }
+
+        AIDEO_LOGI(LOG_TAG_ONNX, "Evicting idle %s session (%lld KiB)",
+                   victimKey->c_str(), static_cast<long long>(victim->estimatedBytes / 1024));
+        if (victim->profiling) {
+            // 세션 소멸 시 ORT 가 trace 는 기록하지만 집계는 되지 않음
+            AIDEO_LOGW(LOG_TAG_ONNX, "Profiling of %s aborted by eviction", victimKey->c_str());
+            victim->profiling = false;
+            updateProfilingSessionsLocked();
+        }
+        residentBytes -= victim->estimatedBytes;
+        evictedSharedSession = evictedSharedSession || victim->profile.sharePrepackedWeights;
+        victim->loaded.reset();
+        ++cacheEvictions_;
+    }
+
+    if (evictedSharedSession) {
+        releaseUnusedPrepackedWeightsLocked();
+    }
+}
+
+void OnnxInference::updateProfilingSessionsLocked() {
+    int profilingSessions = 0;
+    for (const auto& [sessionKey, entry]: sessions_) {
+        if (entry.profilingPending || entry.profiling) {
+            ++profilingSessions;
+        }
+    }
+    profilingSessions_.store(profilingSessions, std::memory_order_release);
+}
+
+void OnnxInference::releaseUnusedPrepackedWeightsLocked() {
+    // 공유 prepack 결과는 저장소가 소유하므로, 세션만 축출해서는 해당 메모리가 반환되지 않음
+    // 등록된 세션 중 저장소를 쓰는 세션이 없고 생성 중인 세션도 없을 때 새 저장소로 교체
+    // 이전 저장소는 등록 해제되었지만 아직 lease 로 실행 중인 세션이 있으면 그 세션이 해제될 때 함께 해제됨
+    if (sessionsInCreation_ > 0) {
+        return;
+    }
+    for (const auto& [sessionKey, entry]: sessions_) {
+        if (entry.loaded && entry.profile.sharePrepackedWeights) {
+            return;
+        }
+    }
+    prepackedWeightsContainer_ = createPrepackedWeightsContainer();
+    AIDEO_LOGI(LOG_TAG_ONNX, "Released shared prepacked weights");
+}
+
+int OnnxInference::defaultIntraOpThreads() {
+    unsigned int totalCores = std::thread::hardware_concurrency();
+    if (totalCores == 0) return 2;  // 감지 실패 시 기본값
+    return static_cast<int>(std::min(4u, std::max(2u, totalCores / 2)));
+}
+
+Ort::Env OnnxInference::createEnv(const ThreadingConfig& threadingConfig) {
+    if (threadingConfig.mode != ThreadPoolMode::kGlobal) {
+        return Ort::Env(ORT_LOGGING_LEVEL_WARNING, "OnnxInference");
+    }
+
+    int intraOpThreads = threadingConfig.intraOpThreads > 0
+                         ? threadingConfig.intraOpThreads
+                         : defaultIntraOpThreads();
+
+    // OrtEnv 는 프로세스 단위 singleton 이라, 먼저 생성된 Env 의 global 스레드 풀을 이후 생성되는 OnnxInference 도 공유함
+    Ort::ThreadingOptions threadingOptions;
+    threadingOptions.SetGlobalIntraOpNumThreads(intraOpThreads);
+    threadingOptions.SetGlobalInterOpNumThreads(std::max(1, threadingConfig.interOpThreads));
+    threadingOptions.SetGlobalSpinControl(threadingConfig.allowSpinning ? 1 : 0);
+
+    AIDEO_LOGI(LOG_TAG_ONNX, "Global thread pool: intra=%d, inter=%d, spinning=%d",
+               intraOpThreads, std::max(1, threadingConfig.interOpThreads),
+               threadingConfig.allowSpinning ? 1 : 0);
+    return Ort::Env(threadingOptions, ORT_LOGGING_LEVEL_WARNING, "OnnxInference");
+}
+
+std::vector<OnnxInference::SessionMemoryReport> OnnxInference::memoryReport() const {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    std::vector<SessionMemoryReport> report;
+    report.reserve(sessions_.size());
+    for (const auto& [sessionKey, entry]: sessions_) {
+        if (!entry.loaded) {
+            continue;
+        }
+        report.push_back(SessionMemoryReport{
+                sessionKey, entry.residentBytesDelta, entry.profile.sharePrepackedWeights });
+    }
+    return report;
 }
 
 void OnnxInference::release() {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
     sessions_.clear();
+    updateProfilingSessionsLocked();
+}
+
+void OnnxInference::releaseSession(const std::string& sessionKey) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    sessions_.erase(sessionKey);
+    updateProfilingSessionsLocked();
+}
+
+bool OnnxInference::isOrtFormatPath(const char* modelPath) {
+    static const std::string kOrtExtension = ".ort";
+    std::string path(modelPath);
+    return path.size() > kOrtExtension.size() &&
+           path.compare(path.size() - kOrtExtension.size(), kOrtExtension.size(), kOrtExtension) == 0;
+}
+
+bool OnnxInference::isXnnpackAvailable() {
+    static const bool available = []() {
+        auto providers = Ort::GetAvailableProviders();
+        return std::find(providers.begin(), providers.end(), "XnnpackExecutionProvider") !=
+               providers.end();
+    }();
+    return available;
+}
+
+void OnnxInference::setOptimizedModelCacheDirectory(std::string cacheDirectory) {
+    optimizedModelCache_.setCacheDirectory(std::move(cacheDirectory));
 }
 
-std::unique_ptr<Ort::Session> OnnxInference::createSession(
+Ort::SessionOptions OnnxInference::createSessionOptions(const SessionProfile& profile) const {
+    Ort::SessionOptions sessionOptions;
+
+    if (threadPoolMode_ == ThreadPoolMode::kGlobal && profile.useGlobalThreadPool) {
+        // Env 의 global 스레드 풀 사용: 세션별 스레드 풀을 만들지 않으므로 세션 수와 무관하게 워커 수가 고정됨
+        sessionOptions.DisablePerSessionThreads();
+        if (profile.threadAffinity.mode != ThreadAffinity::Mode::kNone) {
+            AIDEO_LOGW(LOG_TAG_ONNX, "Thread affinity is ignored for sessions on the global thread pool");
+        }
+    } else {
+        // 스레드 수는 성능을 위해 적정 수준 유지 (코어의 절반, 2~4개)
+        // TODO : JVM 스레드 수와 연동되나? 만약 그렇다면, 스레드 수가 너무 많은 건 좋지 않음.
+        // 하나의 샘플에 대해 병렬 연산할 수 있을 때, 몇개의 스레드로 실행할 것 인지
+        int intraOpThreads = profile.intraOpThreads > 0 ? profile.intraOpThreads : intraOpThreads_;
+        sessionOptions.SetIntraOpNumThreads(intraOpThreads);
+        sessionOptions.SetInterOpNumThreads(std::max(1, profile.interOpThreads));
+        sessionOptions.AddConfigEntry(
+                kOrtSessionOptionsConfigAllowIntraOpSpinning, profile.allowSpinning ? "1" : "0");
+
+        // 워커가 little 코어에 배치되면 step 전체가 가장 느린 워커를 기다리게 됨
+        std::string affinities = CpuTopology::intraOpAffinities(profile.threadAffinity, intraOpThreads);
+        if (!affinities.empty()) {
+            sessionOptions.AddConfigEntry(
+                    kOrtSessionOptionsConfigIntraOpThreadAffinities, affinities.c_str());
+            AIDEO_LOGI(LOG_TAG_ONNX, "Intra-op thread affinities: %s", affinities.c_str());
+        }
+    }
+
+    if (!profile.profilingFilePrefix.empty()) {
+        sessionOptions.EnableProfiling(profile.profilingFilePrefix.c_str());
+    }
+
+    sessionOptions.SetExecutionMode(profile.executionMode);
+    sessionOptions.SetGraphOptimizationLevel(profile.graphOptimizationLevel);
+
+    // 메모리 최적화: Arena allocator 비활성화
+    // Arena는 메모리를 미리 할당하고 해제를 지연시켜 메모리 사용량 증가
+    // 비활성화하면 즉시 해제되어 메모리 사용량 감소
+    if (profile.enableCpuMemArena) {
+        sessionOptions.EnableCpuMemArena();
+    } else {
+        sessionOptions.DisableCpuMemArena();
+    }
+
+    // 메모리 패턴 최적화: 실행 중 메모리 할당 패턴을 분석하여 재사용
+    if (profile.enableMemPattern) {
+        sessionOptions.EnableMemPattern();
+    } else {
+        sessionOptions.DisableMemPattern();
+    }
+
+    for (const auto& [dimension, value]: profile.freeDimensionOverrides) {
+        Ort::ThrowOnError(Ort::GetApi().AddFreeDimensionOverrideByName(
+                sessionOptions, dimension.c_str(), value));
+    }
+
+    if (profile.executionProvider == SessionProfile::ExecutionProvider::kXnnpackWithCpuFallback) {
+        if (isXnnpackAvailable()) {
+            int xnnpackThreads = profile.xnnpackThreads > 0 ? profile.xnnpackThreads : intraOpThreads_;
+            // XNNPACK 이 지원하지 않는 노드는 CPU EP 가 실행
+            sessionOptions.AddConfigEntry(kOrtSessionOptionsDisableCPUEPFallback, "0");
+            sessionOptions.AppendExecutionProvider(
+                    "XNNPACK", { { "intra_op_num_threads", std::to_string(xnnpackThreads) } });
+        } else {
+            AIDEO_LOGW(LOG_TAG_ONNX, "XNNPACK EP is not available in this build, using CPU EP only");
+        }
+    }
+
+    return sessionOptions;
+}
+
+OnnxInference::LoadedSession OnnxInference::createSession(
         const char* modelPath,
-        const char* modelName) {
+        const char* modelName,
+        const SessionProfile& profile) {
+    LoadedSession entry;
     if (aideo::isInvalidPath(modelPath)) {
         AIDEO_LOGE(LOG_TAG_ONNX, "Invalid %s path", modelName);
-        return nullptr;
+        return entry;
+    }
+
+    // XNNPACK 세션의 최적화 그래프에는 EP 전용 layout 변환(NHWC) 결과가 포함될 수 있어 ORT format 으로 재사용하지 않음
+    bool canUseOptimizedModelCache = profile.useOptimizedModelCache &&
+            profile.executionProvider == SessionProfile::ExecutionProvider::kCpu;
+    if (canUseOptimizedModelCache) {
+        entry = createSessionWithOptimizedModelCache(modelPath, modelName, profile);
+        if (entry.session) {
+            return entry;
+        }
     }
 
     try {
-        return std::make_unique<Ort::Session>(env_, modelPath, sessionOptions_);
+        auto sessionOptions = createSessionOptions(profile);
+        if (isOrtFormatPath(modelPath)) {
+            entry = createOrtFormatSession(modelPath, sessionOptions, profile);
+        } else {
+            entry.session = newSession(modelPath, sessionOptions, profile);
+        }
     } catch (const Ort::Exception& e) {
         AIDEO_LOGE(LOG_TAG_ONNX, "Failed to load %s: %s", modelName, e.what());
+        entry = LoadedSession{};
+    }
+    return entry;
+}
+
+OnnxInference::LoadedSession OnnxInference::createSessionWithOptimizedModelCache(
+        const char* modelPath,
+        const char* modelName,
+        const SessionProfile& profile) {
+    LoadedSession entry;
+    auto lookup = optimizedModelCache_.lookup(modelPath, profile.optimizationFingerprint());
+    if (lookup.key.empty()) {
+        return entry;
+    }
+
+    if (lookup.hit) {
+        try {
+            // 이미 최적화가 끝난 그래프이므로 그래프 최적화 단계를 생략
+            auto sessionOptions = createSessionOptions(profile);
+            sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+            entry = createOrtFormatSession(lookup.cachedModelPath.c_str(), sessionOptions, profile);
+            AIDEO_LOGI(LOG_TAG_ONNX, "Loaded %s from optimized model cache", modelName);
+            return entry;
+        } catch (const Ort::Exception& e) {
+            AIDEO_LOGW(LOG_TAG_ONNX, "Discarding optimized model cache of %s: %s",
+                       modelName, e.what());
+            entry = LoadedSession{};
+            optimizedModelCache_.discard(lookup);
+        }
+    }
+
+    try {
+        // 원본 모델을 최적화하면서 그 결과를 ORT format 으로 기록
+        auto sessionOptions = createSessionOptions(profile);
+        sessionOptions.SetOptimizedModelFilePath(lookup.pendingModelPath.c_str());
+        sessionOptions.AddConfigEntry(kOrtSessionOptionsConfigSaveModelFormat, "ORT");
+        entry.session = newSession(modelPath, sessionOptions, profile);
+        if (optimizedModelCache_.commit(lookup)) {
+            entry.ortModelPath = lookup.cachedModelPath;
+        }
+    } catch (const Ort::Exception& e) {
+        AIDEO_LOGW(LOG_TAG_ONNX, "Failed to build optimized model cache of %s: %s",
+                   modelName, e.what());
+        optimizedModelCache_.discard(lookup);
+    }
+    return entry;
+}
+
+OnnxInference::LoadedSession OnnxInference::createOrtFormatSession(
+        const char* modelPath,
+        Ort::SessionOptions& sessionOptions,
+        const SessionProfile& profile) {
+    LoadedSession entry;
+    entry.ortModelPath = modelPath;
+    sessionOptions.AddConfigEntry(kOrtSessionOptionsConfigLoadModelFormat, "ORT");
+
+    if (profile.memoryMapModel) {
+        entry.mappedModel = MappedModelFile::map(modelPath);
+    }
+
+    if (!entry.mappedModel) {
+        // 경로로 로드하면 ORT 가 파일 전체를 heap 버퍼로 읽은 뒤 initializer 를 구성
+        entry.session = newSession(modelPath, sessionOptions, profile);
+        return entry;
+    }
+
+    // mmap 영역을 그대로 flatbuffer 및 initializer 저장소로 사용 → 모델 크기만큼의 heap 복사/RSS 급증 없음
+    // 대신 mappedModel 은 session 이 해제될 때까지 유지되어야 함
+    sessionOptions.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesDirectly, "1");
+    sessionOptions.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "1");
+
+    // 세션 생성(prepack 등)과 병행해 page cache 를 채워, 첫 Run 전에 가중치 페이지가 올라와 있도록 함
+    entry.mappedModel->startReadahead();
+    entry.session = newSession(
+            entry.mappedModel->data(), entry.mappedModel->size(), sessionOptions, profile);
+    return entry;
+}
+
+std::unique_ptr<Ort::Session> OnnxInference::newSession(
+        const char* modelPath,
+        const Ort::SessionOptions& sessionOptions,
+        const SessionProfile& profile) {
+    if (profile.sharePrepackedWeights && prepackedWeightsContainer_) {
+        return std::make_unique<Ort::Session>(
+                env_, modelPath, sessionOptions, prepackedWeightsContainer_.get());
+    }
+    return std::make_unique<Ort::Session>(env_, modelPath, sessionOptions);
+}
+
+std::unique_ptr<Ort::Session> OnnxInference::newSession(
+        const void* modelData,
+        size_t modelDataLength,
+        const Ort::SessionOptions& sessionOptions,
+        const SessionProfile& profile) {
+    if (profile.sharePrepackedWeights && prepackedWeightsContainer_) {
+        return std::make_unique<Ort::Session>(
+                env_, modelData, modelDataLength, sessionOptions, prepackedWeightsContainer_.get());
+    }
+    return std::make_unique<Ort::Session>(env_, modelData, modelDataLength, sessionOptions);
+}
+
+OnnxInference::PrepackedWeightsContainerPtr OnnxInference::createPrepackedWeightsContainer() {
+    OrtPrepackedWeightsContainer* container = nullptr;
+    OrtStatus* status = Ort::GetApi().CreatePrepackedWeightsContainer(&container);
+    if (status != nullptr) {
+        // 공유 없이 세션별 prepack 으로 동작
+        AIDEO_LOGW(LOG_TAG_ONNX, "Failed to create prepacked weights container: %s",
+                   Ort::GetApi().GetErrorMessage(status));
+        Ort::GetApi().ReleaseStatus(status);
+        container = nullptr;
+    }
+    if (container == nullptr) {
         return nullptr;
     }
+    return PrepackedWeightsContainerPtr(container, [](OrtPrepackedWeightsContainer* ptr) {
+        if (ptr != nullptr) {
+            Ort::GetApi().ReleasePrepackedWeightsContainer(ptr);
+        }
+    });
 }
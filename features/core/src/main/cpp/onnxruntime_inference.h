@@ -1,41 +1,368 @@
 #ifndef AIDEO_ONNXRUNTIME_INFERENCE_H
 #define AIDEO_ONNXRUNTIME_INFERENCE_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "logging.h"
+#include "mapped_model_file.h"
 #include "onnxruntime_cxx_api.h"
+#include "optimized_model_cache.h"
+#include "ort_profile_summary.h"
+#include "session_profile.h"
+#include "session_run_stats.h"
 
 #define LOG_TAG_ONNX "ONNX_Native"
 
 class OnnxInference {
 public:
+    // intra-op 스레드 풀 운용 방식
+    enum class ThreadPoolMode {
+        // 세션마다 자체 intra-op 스레드 풀을 생성 (ORT 기본 동작)
+        kPerSession,
+        // Env 에 global 스레드 풀을 만들고, 모든 세션이 DisablePerSessionThreads() 로 이를 공유
+        kGlobal,
+    };
+
+    struct ThreadingConfig {
+        ThreadPoolMode mode = ThreadPoolMode::kPerSession;
+        // 0 이하면 defaultIntraOpThreads() 사용
+        int intraOpThreads = 0;
+        int interOpThreads = 1;
+        // global 스레드 풀의 spin-wait 허용 여부 (kGlobal 에서만 사용)
+        bool allowSpinning = true;
+    };
+
+    // 세션 생성 직후 측정한 메모리 사용량
+    struct SessionMemoryReport {
+        std::string sessionKey;
+        // 세션 생성 전후 RSS 차이. 여러 세션을 동시에 생성하면 서로의 증가분이 섞이므로 근사값
+        int64_t residentBytesDelta = 0;
+        bool sharesPrepackedWeights = false;
+    };
+
+    // 세션 캐시 누적 통계
+    struct SessionCacheStats {
+        // getSession() 시 세션이 메모리에 있었던 횟수
+        int64_t hits = 0;
+        // getSession() 시 축출되어 있어 다시 로드한 횟수
+        int64_t misses = 0;
+        int64_t evictions = 0;
+        // 메모리에 올라와 있는 세션들의 추정 사용량 합
+        int64_t residentBytes = 0;
+        int64_t memoryBudgetBytes = 0;
+        int residentSessions = 0;
+        int registeredSessions = 0;
+    };
+
+    struct ProfilingConfig {
+        // trace JSON 저장 디렉토리 (없으면 생성)
+        std::string outputDirectory;
+        // 세션별로 이 횟수만큼 Run 한 뒤 profiling 을 끝내고 집계
+        int maxRuns = 20;
+        // 세션별 요약에 남길 op 개수
+        int topOpCount = 10;
+    };
+
+private:
+    struct LoadedSession;
+
+public:
+    // getSession() 이 반환하는 세션 사용권. 보유하는 동안 해당 세션은 축출되지 않음
+    class SessionLease {
+    public:
+        SessionLease() = default;
+
+        SessionLease(std::nullptr_t) {}
+
+        Ort::Session* get() const;
+
+        Ort::Session& operator*() const { return *get(); }
+
+        Ort::Session* operator->() const { return get(); }
+
+        explicit operator bool() const { return loaded_ != nullptr; }
+
+    private:
+        friend class OnnxInference;
+
+        explicit SessionLease(std::shared_ptr<LoadedSession> loaded) : loaded_(std::move(loaded)) {}
+
+        std::shared_ptr<LoadedSession> loaded_;
+    };
+
     OnnxInference();
 
+    explicit OnnxInference(const ThreadingConfig& threadingConfig);
+
     ~OnnxInference();
 
+    /**
+     * [modelPath] 의 모델로 세션을 생성해 [sessionKey] 로 등록
+     *
+     * 서로 다른 [sessionKey] 에 대해 여러 스레드에서 동시에 호출 가능 \n
+     * 등록된 세션은 메모리 예산 초과 시 축출될 수 있고, 다음 getSession() 에서 같은 설정으로 다시 로드됨
+     * @param profile : 세션별 스레드/메모리/최적화 설정
+     */
     bool loadSession(
             const std::string& sessionKey,
             const char* modelPath,
-            const char* modelName
+            const char* modelName,
+            const SessionProfile& profile = SessionProfile{}
     );
 
+    // 등록 여부 (축출되어 메모리에 없더라도 getSession() 으로 다시 로드 가능하면 true)
     bool hasSession(const std::string& sessionKey) const;
 
-    Ort::Session* getSession(const std::string& sessionKey, const char* modelName);
+    /**
+     * [sessionKey] 세션을 만든 ORT format 모델 경로 — 최적화 모델 캐시(확정된 것만) 또는 원본 .ort
+     *
+     * 같은 그래프의 세션을 더 만들 때 이 경로로 로드하면 최적화/캐시 기록 없이 mmap 으로 가중치를 공유
+     * @return 미등록이거나 ONNX 원본에서 직접 만든 세션이면 빈 문자열
+     */
+    std::string ortModelPath(const std::string& sessionKey) const;
+
+    /**
+     * [sessionKey] 세션의 사용권 반환. 축출된 세션이면 등록 시의 경로/설정으로 다시 로드
+     *
+     * @return 미등록 또는 재로드 실패 시 nullptr
+     */
+    SessionLease getSession(const std::string& sessionKey, const char* modelName);
+
+    /**
+     * [session] 으로 Run 하고, 세션 키 단위의 부가 처리(Run 통계, profiling 종료/집계 등)를 수행
+     *
+     * [session] 은 getSession([sessionKey]) 로 얻은 세션이어야 함. Run 의 예외는 그대로 전달
+     * Run 통계는 세션별 잠금으로 기록하고, sessionsMutex_ 는 profiling 중인 세션이 있을 때만 잡음
+     */
+    std::vector<Ort::Value> run(
+            const std::string& sessionKey,
+            const SessionLease& session,
+            const Ort::RunOptions& runOptions,
+            const char* const* inputNames,
+            const Ort::Value* inputValues,
+            size_t inputCount,
+            const char* const* outputNames,
+            size_t outputCount
+    );
+
+    /**
+     * 출력 텐서를 호출 측이 미리 할당해 전달하는 run()
+     *
+     * [outputValues] 중 null 인 항목은 ORT 가 기본 allocator 로 할당해 채움. shape 이 실제 출력과 다르면 Run 이 실패함
+     */
+    void run(
+            const std::string& sessionKey,
+            const SessionLease& session,
+            const Ort::RunOptions& runOptions,
+            const char* const* inputNames,
+            const Ort::Value* inputValues,
+            size_t inputCount,
+            const char* const* outputNames,
+            Ort::Value* outputValues,
+            size_t outputCount
+    );
+
+    /**
+     * [ioBinding] 에 바인딩된 입출력으로 Run
+     *
+     * 출력은 미리 할당해 바인딩한 Value 를 그대로 읽고, ORT 가 할당한 출력이 있을 때만 호출 측이
+     * [ioBinding].GetOutputValues() 로 꺼냄 (Run 마다 출력 Value 를 새로 만들지 않도록)
+     * @param inputBytes, outputBytes : 바인딩한 입출력 텐서 크기 합 (통계용). Run 마다 ORT 에 shape 을 조회하지 않도록
+     * 바인딩한 shape 을 아는 호출 측이 계산
+     */
+    void run(
+            const std::string& sessionKey,
+            const SessionLease& session,
+            const Ort::RunOptions& runOptions,
+            Ort::IoBinding& ioBinding,
+            int64_t inputBytes,
+            int64_t outputBytes
+    );
+
+    // null 이거나 tensor 가 아닌 값은 제외 (텐서마다 shape 정보를 조회하므로 step 단위 경로에서는 사용하지 않음)
+    static int64_t tensorBytes(const Ort::Value* values, size_t count);
+
+    // 마지막 resetRunStats() 이후 세션 키별 Run 시간/텐서 크기 통계 (세션이 축출/재로드되어도 유지, 등록 해제된 세션은 제외)
+    std::vector<SessionRunStats> runStats() const;
+
+    void resetRunStats();
 
     void release();
 
+    // [sessionKey] 세션만 등록 해제 (사용 중인 lease 는 반납될 때 해제됨)
+    void releaseSession(const std::string& sessionKey);
+
+    /**
+     * 등록된 세션들을 ORT profiling 을 켠 상태로 다시 생성하고, 세션별로 maxRuns 회 Run 한 뒤 trace 를 집계
+     *
+     * 사용 중인 세션은 다음 getSession() 에서 사용 중이 아닐 때 다시 생성됨
+     * @return 출력 디렉토리를 사용할 수 없으면 false
+     */
+    bool startProfiling(const ProfilingConfig& config);
+
+    // profiling 이 끝난 세션들의 op 별 집계
+    std::vector<OrtProfileSummary> profilingSummaries() const;
+
+    // 메모리에 올라와 있는 세션만 포함
+    std::vector<SessionMemoryReport> memoryReport() const;
+
+    /**
+     * 메모리에 올라와 있는 세션들의 추정 사용량 상한 (0 이하면 무제한)
+     *
+     * 초과 시 사용 중이 아닌 세션을 오래전에 사용한 순서로 축출. 예산을 낮추면 즉시 적용됨
+     */
+    void setMemoryBudget(int64_t budgetBytes);
+
+    SessionCacheStats sessionCacheStats() const;
+
+    // SessionProfile::useOptimizedModelCache 세션의 최적화 모델 저장 위치 (빈 문자열이면 원본 모델 옆)
+    void setOptimizedModelCacheDirectory(std::string cacheDirectory);
+
+    ThreadPoolMode threadPoolMode() const { return threadPoolMode_; }
+
+    // 코어의 절반, 2~4개 (감지 실패 시 2개)
+    static int defaultIntraOpThreads();
+
 private:
-    std::unique_ptr<Ort::Session> createSession(
+    // 저장소를 참조하는 세션이 모두 해제될 때 함께 해제됨
+    using PrepackedWeightsContainerPtr = std::shared_ptr<OrtPrepackedWeightsContainer>;
+
+    // 세션 키 하나의 Run 통계. 세션이 축출/재로드되어도 같은 객체를 유지
+    struct RunStatsSlot {
+        std::mutex mutex;
+        SessionRunStatsRecorder recorder;
+    };
+
+    struct LoadedSession {
+        // 생성 시 사용한 공유 prepack 저장소 (sharePrepackedWeights 가 아니면 nullptr)
+        // 등록 해제/저장소 교체 후에도 lease 로 실행 중일 수 있으므로 세션이 직접 보유 → session 보다 나중에 해제됨
+        PrepackedWeightsContainerPtr prepackedWeights;
+        // session 이 직접 참조하는 mmap 영역 → 선언 역순 해제로 session 보다 나중에 해제됨
+        std::unique_ptr<MappedModelFile> mappedModel;
+        std::unique_ptr<Ort::Session> session;
+        // session 을 만든 ORT format 모델 경로 (ONNX 원본에서 만들었으면 빈 문자열)
+        std::string ortModelPath;
+        // SessionEntry::runStats 와 같은 객체 — Run 경로에서 세션 목록을 조회하지 않고 기록
+        std::shared_ptr<RunStatsSlot> runStats;
+    };
+
+    struct SessionEntry {
+        // 축출되면 nullptr. SessionLease 가 공유하므로 use_count() == 1 이면 사용 중이 아님
+        std::shared_ptr<LoadedSession> loaded;
+        std::shared_ptr<RunStatsSlot> runStats;
+        // 재로드용 등록 정보
+        std::string modelPath;
+        std::string modelName;
+        SessionProfile profile;
+        std::string ortModelPath;
+        int64_t residentBytesDelta = 0;
+        // 예산 계산에 쓰는 추정 사용량
+        int64_t estimatedBytes = 0;
+        std::chrono::steady_clock::time_point lastUsed;
+        // startProfiling() 이후 profiling 세션으로 다시 생성되어야 함
+        bool profilingPending = false;
+        // profiling 이 켜진 세션으로 실행 중
+        bool profiling = false;
+        int profiledRuns = 0;
+    };
+
+    static PrepackedWeightsContainerPtr createPrepackedWeightsContainer();
+
+    static Ort::Env createEnv(const ThreadingConfig& threadingConfig);
+
+    static bool isOrtFormatPath(const char* modelPath);
+
+    // 현재 ORT 빌드에 XNNPACK EP 가 포함되어 있는지
+    static bool isXnnpackAvailable();
+
+    Ort::SessionOptions createSessionOptions(const SessionProfile& profile) const;
+
+    // 세션 생성 후 RSS 증가량과 추정 사용량을 채운 SessionEntry 반환. 실패 시 loaded == nullptr
+    SessionEntry buildSessionEntry(
+            const char* modelPath,
+            const char* modelName,
+            const SessionProfile& profile
+    );
+
+    // sessionsMutex_ 를 잡은 상태에서 호출. 예산을 넘으면 사용 중이 아닌 세션을 LRU 순으로 축출 ([protectedSessionKey] 제외)
+    void enforceMemoryBudgetLocked(const std::string& protectedSessionKey);
+
+    // Run 통계를 기록하고, profiling 중인 세션은 Run 횟수가 maxRuns 에 도달하면 profiling 종료 후 trace 집계
+    void onRunCompleted(
+            const std::string& sessionKey,
+            const SessionLease& session,
+            int64_t elapsedMicros,
+            int64_t inputBytes,
+            int64_t outputBytes
+    );
+
+    // sessionsMutex_ 를 잡은 상태에서 호출. profiling 대기/진행 중인 세션 수를 profilingSessions_ 에 반영
+    void updateProfilingSessionsLocked();
+
+    // sessionsMutex_ 를 잡은 상태에서 호출. 공유 prepack 결과를 쓰는 세션이 하나도 없으면 저장소를 비움
+    void releaseUnusedPrepackedWeightsLocked();
+
+    LoadedSession createSession(
+            const char* modelPath,
+            const char* modelName,
+            const SessionProfile& profile
+    );
+
+    // 최적화 모델 캐시를 거쳐 세션 생성. 캐시를 사용할 수 없으면 session == nullptr (예외 없음)
+    LoadedSession createSessionWithOptimizedModelCache(
             const char* modelPath,
-            const char* modelName
+            const char* modelName,
+            const SessionProfile& profile
+    );
+
+    // ORT format 모델로 세션 생성. [memoryMap] 이면 파일을 mmap 해 복사 없이 flatbuffer/initializer 로 직접 사용
+    LoadedSession createOrtFormatSession(
+            const char* modelPath,
+            Ort::SessionOptions& sessionOptions,
+            const SessionProfile& profile
+    );
+
+    std::unique_ptr<Ort::Session> newSession(
+            const char* modelPath,
+            const Ort::SessionOptions& sessionOptions,
+            const SessionProfile& profile
+    );
+
+    std::unique_ptr<Ort::Session> newSession(
+            const void* modelData,
+            size_t modelDataLength,
+            const Ort::SessionOptions& sessionOptions,
+            const SessionProfile& profile
     );
 
+    ThreadPoolMode threadPoolMode_;
+    int intraOpThreads_;
     Ort::Env env_;
-    Ort::SessionOptions sessionOptions_;
-    std::unordered_map<std::string, std::unique_ptr<Ort::Session>> sessions_;
+    OptimizedModelCache optimizedModelCache_;
+    // 이후 생성하는 sharePrepackedWeights 세션들이 공유할 prepack 결과 저장소 (각 세션도 참조를 보유)
+    PrepackedWeightsContainerPtr prepackedWeightsContainer_;
+    // 세션 생성은 병렬로 진행되고, 등록/조회만 직렬화
+    mutable std::mutex sessionsMutex_;
+    std::unordered_map<std::string, SessionEntry> sessions_;
+    // 생성 중인 세션 수 — 생성 중에는 prepack 저장소를 교체하지 않음 (sessionsMutex_ 로 보호)
+    int sessionsInCreation_ = 0;
+    int64_t memoryBudgetBytes_ = 0;
+    int64_t cacheHits_ = 0;
+    int64_t cacheMisses_ = 0;
+    int64_t cacheEvictions_ = 0;
+    ProfilingConfig profilingConfig_;
+    std::vector<OrtProfileSummary> profilingSummaries_;
+    // profilingPending 또는 profiling 인 세션 수 — 0 이면 Run 마다 sessionsMutex_ 를 잡지 않고 profiling 확인을 건너뜀
+    std::atomic<int> profilingSessions_{ 0 };
+    // 같은 세션을 여러 스레드가 동시에 재로드하지 않도록 재로드만 직렬화
+    std::mutex reloadMutex_;
 };
 
 #endif
@@ -0,0 +1,189 @@
+#include "optimized_model_cache.h"
+#include "onnxruntime_cxx_api.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <sys/auxv.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // 모델 파일 전체(수백 MB)를 매 로드마다 해싱하면 캐시로 줄인 시간보다 해싱 비용이 커짐
+    // → 파일 크기 + 수정 시각 + 앞/중간/끝 구간 샘플 해시로 파일을 식별
+    constexpr size_t kHashSampleSize = 1 << 20;
+
+    constexpr uint64_t kFnvOffsetBasis = 1469598103934665603ULL;
+    constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+    uint64_t fnv1a(const char* data, size_t size, uint64_t hash) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= kFnvPrime;
+        }
+        return hash;
+    }
+
+    std::string directoryOf(const std::string& path) {
+        auto slash = path.find_last_of('/');
+        return slash == std::string::npos ? "." : path.substr(0, slash);
+    }
+
+    std::string fileNameOf(const std::string& path) {
+        auto slash = path.find_last_of('/');
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    // 파일 이름에 넣을 최적화 설정 식별자 (8 hex) — 충돌해도 키 파일 비교에서 miss 로 처리됨
+    std::string fingerprintTag(const std::string& optimizationFingerprint) {
+        uint64_t hash = fnv1a(optimizationFingerprint.data(), optimizationFingerprint.size(), kFnvOffsetBasis);
+        char tag[9];
+        std::snprintf(tag, sizeof(tag), "%08x", static_cast<unsigned int>(hash ^ (hash >> 32)));
+        return tag;
+    }
+}
+
+OptimizedModelCache::OptimizedModelCache(std::string cacheDirectory)
+        : cacheDirectory_(std::move(cacheDirectory)) {}
+
+void OptimizedModelCache::setCacheDirectory(std::string cacheDirectory) {
+    cacheDirectory_ = std::move(cacheDirectory);
+}
+
+OptimizedModelCache::Lookup OptimizedModelCache::lookup(
+        const char* modelPath,
+        const std::string& optimizationFingerprint
+) const {
+    Lookup lookup;
+
+    std::string modelPathStr(modelPath);
+    std::string directory = cacheDirectory_.empty() ? directoryOf(modelPathStr) : cacheDirectory_;
+    if (access(directory.c_str(), W_OK) != 0) {
+        AIDEO_LOGW(LOG_TAG_MODEL_CACHE, "Cache directory is not writable: %s", directory.c_str());
+        return lookup;
+    }
+
+    std::string modelHash = computeModelHash(modelPath);
+    if (modelHash.empty()) {
+        return lookup;
+    }
+
+    lookup.key = modelHash + "|ort=" + Ort::GetVersionString() + "|cpu=" + cpuFeatures() +
+                 "|" + optimizationFingerprint;
+    // 같은 모델을 서로 다른 최적화 설정(프리셋 변경, free dimension 등)으로 로드해도 캐시를 서로 덮어쓰지 않도록 설정별 파일
+    lookup.cachedModelPath = directory + "/" + fileNameOf(modelPathStr) + "." +
+                             fingerprintTag(optimizationFingerprint) + ".optimized.ort";
+    lookup.pendingModelPath = lookup.cachedModelPath + ".tmp";
+    lookup.keyPath = lookup.cachedModelPath + ".key";
+
+    struct stat cachedStat{};
+    if (stat(lookup.cachedModelPath.c_str(), &cachedStat) != 0 || cachedStat.st_size == 0) {
+        return lookup;
+    }
+
+    std::ifstream keyFile(lookup.keyPath);
+    std::string storedKey;
+    if (keyFile.is_open() && std::getline(keyFile, storedKey) && storedKey == lookup.key) {
+        lookup.hit = true;
+    } else {
+        AIDEO_LOGI(LOG_TAG_MODEL_CACHE, "Cache invalidated: %s", lookup.cachedModelPath.c_str());
+    }
+    return lookup;
+}
+
+bool OptimizedModelCache::commit(const Lookup& lookup) const {
+    if (lookup.key.empty()) {
+        return false;
+    }
+
+    // 키 파일을 나중에 기록 → 모델 교체 도중 종료되어도 키가 맞지 않아 다음 로드에서 miss 처리됨
+    std::remove(lookup.keyPath.c_str());
+    if (std::rename(lookup.pendingModelPath.c_str(), lookup.cachedModelPath.c_str()) != 0) {
+        AIDEO_LOGW(LOG_TAG_MODEL_CACHE, "Failed to store optimized model: %s",
+                   lookup.cachedModelPath.c_str());
+        discard(lookup);
+        return false;
+    }
+
+    std::string pendingKeyPath = lookup.keyPath + ".tmp";
+    {
+        std::ofstream keyFile(pendingKeyPath, std::ios::trunc);
+        if (!keyFile.is_open() || !(keyFile << lookup.key << '\n')) {
+            AIDEO_LOGW(LOG_TAG_MODEL_CACHE, "Failed to write cache key: %s",
+                       lookup.keyPath.c_str());
+            discard(lookup);
+            return false;
+        }
+    }
+    if (std::rename(pendingKeyPath.c_str(), lookup.keyPath.c_str()) != 0) {
+        discard(lookup);
+        return false;
+    }
+
+    AIDEO_LOGI(LOG_TAG_MODEL_CACHE, "Stored optimized model: %s", lookup.cachedModelPath.c_str());
+    return true;
+}
+
+void OptimizedModelCache::discard(const Lookup& lookup) const {
+    if (lookup.key.empty()) {
+        return;
+    }
+    std::remove(lookup.keyPath.c_str());
+    std::remove((lookup.keyPath + ".tmp").c_str());
+    std::remove(lookup.pendingModelPath.c_str());
+    std::remove(lookup.cachedModelPath.c_str());
+}
+
+std::string OptimizedModelCache::computeModelHash(const char* modelPath) {
+    struct stat modelStat{};
+    if (stat(modelPath, &modelStat) != 0) {
+        AIDEO_LOGW(LOG_TAG_MODEL_CACHE, "Failed to stat model: %s", modelPath);
+        return "";
+    }
+
+    std::ifstream file(modelPath, std::ios::binary);
+    if (!file.is_open()) {
+        AIDEO_LOGW(LOG_TAG_MODEL_CACHE, "Failed to open model: %s", modelPath);
+        return "";
+    }
+
+    auto fileSize = static_cast<uint64_t>(modelStat.st_size);
+    std::vector<uint64_t> sampleOffsets = { 0 };
+    if (fileSize > kHashSampleSize) {
+        sampleOffsets.push_back((fileSize - kHashSampleSize) / 2);
+        sampleOffsets.push_back(fileSize - kHashSampleSize);
+    }
+
+    uint64_t hash = kFnvOffsetBasis;
+    std::vector<char> buffer(kHashSampleSize);
+    for (uint64_t offset: sampleOffsets) {
+        file.seekg(static_cast<std::streamoff>(offset));
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash = fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+        file.clear();
+    }
+
+    std::ostringstream out;
+    out << "size=" << fileSize
+        << "|mtime=" << static_cast<long long>(modelStat.st_mtime)
+        << "|fnv=" << std::hex << hash;
+    return out.str();
+}
+
+std::string OptimizedModelCache::cpuFeatures() {
+    // ORT_ENABLE_ALL 로 최적화된 ORT format 모델은 최적화 당시 CPU 의 kernel 선택(예: dot-product, i8mm)에 종속됨
+    std::ostringstream out;
+#if defined(__aarch64__)
+    out << "arm64";
+#elif defined(__x86_64__)
+    out << "x86_64";
+#else
+    out << "unknown";
+#endif
+    out << std::hex
+        << ":" << getauxval(AT_HWCAP)
+        << ":" << getauxval(AT_HWCAP2);
+    return out.str();
+}
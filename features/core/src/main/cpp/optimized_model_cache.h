@@ -0,0 +1,56 @@
+#ifndef AIDEO_OPTIMIZED_MODEL_CACHE_H
+#define AIDEO_OPTIMIZED_MODEL_CACHE_H
+
+#include <string>
+#include "logging.h"
+
+#define LOG_TAG_MODEL_CACHE "OptimizedModelCache"
+
+// ORT 그래프 최적화가 끝난 모델을 ORT format 으로 디스크에 보관
+//   - 캐시 키 : [모델 파일 해시 | ORT 버전 | CPU features | 최적화에 영향을 주는 세션 설정]
+//   - 키가 하나라도 달라지면 캐시는 자동으로 무효(miss) 처리되고 다음 로드에서 다시 생성됨
+//   - 파일 : "<모델 파일명>.<최적화 설정 해시>.optimized.ort" — 최적화 설정마다 별도 파일이라 서로 무효화하지 않음
+class OptimizedModelCache {
+public:
+    struct Lookup {
+        // 유효한 캐시가 존재하는지
+        bool hit = false;
+        // 캐시된 ORT format 모델 경로
+        std::string cachedModelPath;
+        // miss 시 ORT 가 최적화 결과를 기록할 임시 경로 (commit() 에서 cachedModelPath 로 교체)
+        std::string pendingModelPath;
+        std::string keyPath;
+        std::string key;
+    };
+
+    /**
+     * @param cacheDirectory : 캐시 저장 디렉터리. 비어 있으면 원본 모델 파일 옆에 저장
+     */
+    explicit OptimizedModelCache(std::string cacheDirectory = "");
+
+    void setCacheDirectory(std::string cacheDirectory);
+
+    /**
+     * 원본 모델과 세션 설정으로 캐시 키를 계산하고, 저장된 캐시의 유효성을 확인
+     *
+     * @param modelPath : 원본 ONNX 모델 경로
+     * @param optimizationFingerprint : 최적화 결과에 영향을 주는 세션 설정 (SessionProfile::optimizationFingerprint())
+     * @return 캐시 디렉터리에 쓸 수 없거나 모델 파일을 읽을 수 없으면 key 가 빈 Lookup
+     */
+    Lookup lookup(const char* modelPath, const std::string& optimizationFingerprint) const;
+
+    // pendingModelPath 에 기록된 최적화 모델을 확정하고 키 파일 기록
+    bool commit(const Lookup& lookup) const;
+
+    // 손상되었거나 기록에 실패한 캐시 제거
+    void discard(const Lookup& lookup) const;
+
+private:
+    static std::string computeModelHash(const char* modelPath);
+
+    static std::string cpuFeatures();
+
+    std::string cacheDirectory_;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "ort_profile_summary.h"
+#include "json.hpp"
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+using json = nlohmann::json;
+
+namespace {
+    constexpr const char* kKernelTimeSuffix = "_kernel_time";
+
+    bool endsWith(const std::string& value, const std::string& suffix) {
+        return value.size() >= suffix.size() &&
+               value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+bool OrtProfileSummary::parse(
+        const std::string& profilePath,
+        int topOpCount,
+        OrtProfileSummary& summary) {
+    std::ifstream file(profilePath);
+    if (!file.is_open()) {
+        AIDEO_LOGE(LOG_TAG_ORT_PROFILE, "Failed to open profile %s", profilePath.c_str());
+        return false;
+    }
+
+    std::unordered_map<std::string, OpStat> opStats;
+    std::unordered_map<std::string, ProviderStat> providerStats;
+    std::unordered_map<std::string, std::unordered_set<std::string>> providerNodes;
+    int64_t totalKernelMicros = 0;
+    try {
+        json trace = json::parse(file);
+        if (!trace.is_array()) {
+            AIDEO_LOGE(LOG_TAG_ORT_PROFILE, "Unexpected profile format: %s", profilePath.c_str());
+            return false;
+        }
+
+        for (const auto& event: trace) {
+            // 세션 초기화/모델 Run 단위 이벤트는 제외하고 노드 단위 kernel 시간만 사용
+            if (event.value("cat", "") != "Node" ||
+                !endsWith(event.value("name", ""), kKernelTimeSuffix) ||
+                !event.contains("args") ||
+                !event["args"].is_object()) {
+                continue;
+            }
+
+            const auto& args = event["args"];
+            std::string opType = args.value("op_name", "");
+            int64_t duration = event.value("dur", static_cast<int64_t>(0));
+            auto& stat = opStats[opType];
+            stat.opType = std::move(opType);
+            stat.totalMicros += duration;
+            ++stat.calls;
+            totalKernelMicros += duration;
+
+            // 같은 노드가 Run 마다 반복 기록되므로 노드 이름으로 중복 제거
+            std::string provider = args.value("provider", "");
+            std::string nodeName = event["name"].get<std::string>();
+            nodeName.resize(nodeName.size() - std::string(kKernelTimeSuffix).size());
+            auto& providerStat = providerStats[provider];
+            providerStat.provider = provider;
+            providerStat.totalMicros += duration;
+            providerNodes[provider].insert(std::move(nodeName));
+        }
+    } catch (const std::exception& e) {
+        AIDEO_LOGE(LOG_TAG_ORT_PROFILE, "Failed to parse profile %s: %s", profilePath.c_str(), e.what());
+        return false;
+    }
+
+    std::vector<OpStat> sortedOps;
+    sortedOps.reserve(opStats.size());
+    for (auto& [opType, stat]: opStats) {
+        sortedOps.push_back(std::move(stat));
+    }
+    std::sort(sortedOps.begin(), sortedOps.end(), [](const OpStat& lhs, const OpStat& rhs) {
+        return lhs.totalMicros > rhs.totalMicros;
+    });
+    if (topOpCount > 0 && sortedOps.size() > static_cast<size_t>(topOpCount)) {
+        sortedOps.resize(topOpCount);
+    }
+
+    std::vector<ProviderStat> providers;
+    providers.reserve(providerStats.size());
+    for (auto& [provider, stat]: providerStats) {
+        stat.nodes = static_cast<int64_t>(providerNodes[provider].size());
+        providers.push_back(std::move(stat));
+    }
+    std::sort(providers.begin(), providers.end(), [](const ProviderStat& lhs, const ProviderStat& rhs) {
+        return lhs.nodes > rhs.nodes;
+    });
+
+    summary.profilePath = profilePath;
+    summary.totalKernelMicros = totalKernelMicros;
+    summary.topOps = std::move(sortedOps);
+    summary.providers = std::move(providers);
+    return true;
+}
+
+std::string OrtProfileSummary::toJson(const std::vector<OrtProfileSummary>& summaries) {
+    json result = json::array();
+    for (const auto& summary: summaries) {
+        json topOps = json::array();
+        for (const auto& op: summary.topOps) {
+            double share = summary.totalKernelMicros > 0
+                           ? static_cast<double>(op.totalMicros) / summary.totalKernelMicros
+                           : 0.0;
+            topOps.push_back({
+                    { "op", op.opType },
+                    { "us", op.totalMicros },
+                    { "calls", op.calls },
+                    { "share", share },
+            });
+        }
+        json providers = json::array();
+        for (const auto& provider: summary.providers) {
+            providers.push_back({
+                    { "provider", provider.provider },
+                    { "nodes", provider.nodes },
+                    { "us", provider.totalMicros },
+            });
+        }
+        result.push_back({
+                { "session", summary.sessionKey },
+                { "profile", summary.profilePath },
+                { "runs", summary.runs },
+                { "totalKernelUs", summary.totalKernelMicros },
+                { "topOps", std::move(topOps) },
+                { "providers", std::move(providers) },
+        });
+    }
+    return result.dump();
+}
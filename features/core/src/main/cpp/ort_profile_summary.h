@@ -0,0 +1,51 @@
+#ifndef AIDEO_ORT_PROFILE_SUMMARY_H
+#define AIDEO_ORT_PROFILE_SUMMARY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "logging.h"
+
+#define LOG_TAG_ORT_PROFILE "OrtProfile"
+
+// ORT session profiling trace(JSON) 의 노드 실행 시간을 op 타입별로 집계한 결과
+struct OrtProfileSummary {
+    struct OpStat {
+        // 예: MatMulInteger, DynamicQuantizeLinear
+        std::string opType;
+        int64_t totalMicros = 0;
+        int64_t calls = 0;
+    };
+
+    // EP 별 노드 할당 (예: XnnpackExecutionProvider 로 옮겨진 노드 수)
+    struct ProviderStat {
+        std::string provider;
+        // 서로 다른 노드 수
+        int64_t nodes = 0;
+        int64_t totalMicros = 0;
+    };
+
+    std::string sessionKey;
+    std::string profilePath;
+    // profiling 이 켜진 동안의 Run 횟수
+    int runs = 0;
+    // 모든 노드 kernel 실행 시간의 합
+    int64_t totalKernelMicros = 0;
+    // totalMicros 내림차순 상위 N 개
+    std::vector<OpStat> topOps;
+    // nodes 내림차순
+    std::vector<ProviderStat> providers;
+
+    /**
+     * trace 파일의 "Node" 이벤트 중 kernel 실행 시간(*_kernel_time)만 op 타입별, EP 별로 합산
+     *
+     * @param topOpCount : topOps 에 남길 개수 (0 이하면 전부)
+     * @return 파일을 읽거나 파싱하지 못하면 false
+     */
+    static bool parse(const std::string& profilePath, int topOpCount, OrtProfileSummary& summary);
+
+    // JNI 로 전달할 compact JSON 배열
+    static std::string toJson(const std::vector<OrtProfileSummary>& summaries);
+};
+
+#endif
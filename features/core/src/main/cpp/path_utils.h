@@ -1,12 +1,24 @@
 #ifndef AIDEO_PATH_UTILS_H
 #define AIDEO_PATH_UTILS_H
 
+#include <cstdint>
+#include <sys/stat.h>
+
 namespace aideo {
 
     inline bool isInvalidPath(const char* path) {
         return path == nullptr || path[0] == '\0';
     }
 
+    // 파일 크기(bytes). 실패 시 0
+    inline int64_t fileSizeBytes(const char* path) {
+        struct stat fileStat {};
+        if (isInvalidPath(path) || stat(path, &fileStat) != 0) {
+            return 0;
+        }
+        return static_cast<int64_t>(fileStat.st_size);
+    }
+
 }
 
 #endif
@@ -0,0 +1,138 @@
+#ifndef AIDEO_SESSION_PROFILE_H
+#define AIDEO_SESSION_PROFILE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "cpu_topology.h"
+#include "onnxruntime_cxx_api.h"
+
+// 세션 단위 실행 설정 — OnnxInference::loadSession() 에 세션 키 별로 전달
+struct SessionProfile {
+    // 세션에 등록할 EP 구성
+    enum class ExecutionProvider {
+        // 기본 CPU EP 만 사용
+        kCpu,
+        // XNNPACK 이 지원하는 노드는 XNNPACK, 나머지는 CPU EP 로 fallback
+        kXnnpackWithCpuFallback,
+    };
+
+    // Env 가 global 스레드 풀(OnnxInference::ThreadPoolMode::kGlobal)을 가진 경우, 세션별 스레드 풀 없이 공유 풀 사용
+    // false 면 아래 스레드 설정으로 세션 전용 스레드 풀 생성
+    bool useGlobalThreadPool = true;
+    // 0 이하면 OnnxInference 기본값 사용
+    int intraOpThreads = 0;
+    // ORT_PARALLEL 에서만 의미 있음
+    int interOpThreads = 1;
+    // 세션 전용 스레드 풀의 spin-wait 허용 여부 (짧은 Run 이 연속될 때 wake-up 지연 감소)
+    bool allowSpinning = true;
+    // 세션 전용 스레드 풀 워커의 코어 배치 (global 스레드 풀 세션에는 적용되지 않음)
+    // 최적화 결과에는 영향이 없으므로 최적화 모델 캐시 키에는 포함하지 않음
+    ThreadAffinity threadAffinity;
+
+    ExecutionProvider executionProvider = ExecutionProvider::kCpu;
+    // XNNPACK EP 자체 스레드 풀 크기 (0 이하면 OnnxInference 기본 intra-op 스레드 수)
+    int xnnpackThreads = 0;
+
+    // Arena 는 메모리를 미리 할당하고 해제를 지연시켜 메모리 사용량 증가 → 모바일 기본값은 비활성화
+    bool enableCpuMemArena = false;
+    bool enableMemPattern = true;
+    ExecutionMode executionMode = ExecutionMode::ORT_SEQUENTIAL;
+    GraphOptimizationLevel graphOptimizationLevel = GraphOptimizationLevel::ORT_ENABLE_ALL;
+
+    // {dimension denotation/name, value} — dynamic dimension 을 고정값으로 바꿔 shape 추론 및 최적화 범위를 넓힘
+    std::vector<std::pair<std::string, int64_t>> freeDimensionOverrides;
+
+    // 최적화된 그래프를 ORT format 으로 디스크에 캐시하고, 이후 로드에서는 최적화 없이 캐시를 바로 로드
+    bool useOptimizedModelCache = false;
+
+    // OnnxInference 가 소유한 PrepackedWeightsContainer 를 사용 → 같은 initializer 의 prepack 결과를 세션 간 공유
+    // (예: decoder 와 decoder_with_past 는 동일한 decoder 가중치를 가짐)
+    bool sharePrepackedWeights = false;
+
+    // ORT format 모델(최적화 모델 캐시 포함)을 mmap 해서 복사 없이 로드하고, 백그라운드에서 page cache 를 미리 채움
+    bool memoryMapModel = false;
+
+    // 비어 있지 않으면 ORT session profiling 활성화 — trace 는 "<prefix>_<timestamp>.json" 으로 기록됨
+    // 최적화 결과에는 영향이 없으므로 최적화 모델 캐시 키에는 포함하지 않음
+    std::string profilingFilePrefix;
+
+    // 최적화 결과 그래프에 영향을 주는 설정 — 최적화 모델 캐시 키의 일부
+    std::string optimizationFingerprint() const {
+        std::string fingerprint = "opt=" + std::to_string(static_cast<int>(graphOptimizationLevel));
+        for (const auto& [dimension, value]: freeDimensionOverrides) {
+            fingerprint += ";" + dimension + "=" + std::to_string(value);
+        }
+        if (executionProvider == ExecutionProvider::kXnnpackWithCpuFallback) {
+            fingerprint += ";ep=xnnpack";
+        }
+        return fingerprint;
+    }
+
+    SessionProfile withFreeDimension(std::string dimension, int64_t value) const {
+        SessionProfile profile = *this;
+        profile.freeDimensionOverrides.emplace_back(std::move(dimension), value);
+        return profile;
+    }
+
+    SessionProfile withOptimizedModelCache(bool enabled = true) const {
+        SessionProfile profile = *this;
+        profile.useOptimizedModelCache = enabled;
+        return profile;
+    }
+
+    SessionProfile withSharedPrepackedWeights(bool enabled = true) const {
+        SessionProfile profile = *this;
+        profile.sharePrepackedWeights = enabled;
+        return profile;
+    }
+
+    SessionProfile withMemoryMappedModel(bool enabled = true) const {
+        SessionProfile profile = *this;
+        profile.memoryMapModel = enabled;
+        return profile;
+    }
+
+    // XNNPACK 이 자체 스레드 풀로 병렬화하므로, ORT intra-op 풀은 호출 스레드 1개로 두고 spin 도 끔
+    // → 두 스레드 풀이 같은 코어를 두고 경쟁하지 않도록 함
+    SessionProfile withXnnpack(int threads = 0) const {
+        SessionProfile profile = *this;
+        profile.executionProvider = ExecutionProvider::kXnnpackWithCpuFallback;
+        profile.xnnpackThreads = threads;
+        profile.useGlobalThreadPool = false;
+        profile.intraOpThreads = 1;
+        profile.allowSpinning = false;
+        return profile;
+    }
+
+    SessionProfile withThreadAffinity(ThreadAffinity affinity) const {
+        SessionProfile profile = *this;
+        profile.threadAffinity = std::move(affinity);
+        return profile;
+    }
+
+    SessionProfile withProfiling(std::string filePrefix) const {
+        SessionProfile profile = *this;
+        profile.profilingFilePrefix = std::move(filePrefix);
+        return profile;
+    }
+
+    // 한 번의 큰 Run(예: encoder) 용 — 공유 스레드 풀 전체 사용
+    static SessionProfile throughput() {
+        SessionProfile profile;
+        profile.useGlobalThreadPool = true;
+        return profile;
+    }
+
+    // 짧은 Run 이 수백 번 반복되는 경우(예: decoder_with_past) 용 — 소수의 전용 스레드가 spin 하며 대기
+    static SessionProfile lowLatency(int intraOpThreads = 2) {
+        SessionProfile profile;
+        profile.useGlobalThreadPool = false;
+        profile.intraOpThreads = intraOpThreads;
+        profile.allowSpinning = true;
+        return profile;
+    }
+};
+
+#endif
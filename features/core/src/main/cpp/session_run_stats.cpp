@@ -0,0 +1,96 @@
+#include "session_run_stats.h"
+#include <algorithm>
+#include <cmath>
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+const std::array<int64_t, SessionRunStatsRecorder::kBucketCount>&
+SessionRunStatsRecorder::bucketUpperMicros() {
+    static const std::array<int64_t, kBucketCount> bounds = []() {
+        std::array<int64_t, kBucketCount> result{};
+        double bound = 1.0;
+        for (int i = 0; i < kBucketCount; ++i) {
+            // 1 us 단위에서 같은 상한이 반복되지 않도록 최소 1 씩 증가
+            int64_t rounded = static_cast<int64_t>(std::ceil(bound));
+            result[i] = i > 0 ? std::max(rounded, result[i - 1] + 1) : rounded;
+            bound *= 1.2;
+        }
+        return result;
+    }();
+    return bounds;
+}
+
+void SessionRunStatsRecorder::record(int64_t elapsedMicros, int64_t inputBytes, int64_t outputBytes) {
+    elapsedMicros = std::max<int64_t>(0, elapsedMicros);
+    if (runs_ == 0) {
+        minMicros_ = elapsedMicros;
+        maxMicros_ = elapsedMicros;
+    } else {
+        minMicros_ = std::min(minMicros_, elapsedMicros);
+        maxMicros_ = std::max(maxMicros_, elapsedMicros);
+    }
+    ++runs_;
+    totalMicros_ += elapsedMicros;
+    inputBytes_ += inputBytes;
+    outputBytes_ += outputBytes;
+
+    const auto& bounds = bucketUpperMicros();
+    auto bucket = std::lower_bound(bounds.begin(), bounds.end(), elapsedMicros);
+    // 마지막 bucket 은 상한 초과분까지 수용
+    size_t index = std::min<size_t>(bucket - bounds.begin(), kBucketCount - 1);
+    ++buckets_[index];
+}
+
+int64_t SessionRunStatsRecorder::percentileMicros(double quantile) const {
+    if (runs_ == 0) {
+        return 0;
+    }
+    // quantile 위치의 Run 이 속한 bucket (1-based 순위)
+    auto rank = static_cast<int64_t>(std::ceil(quantile * static_cast<double>(runs_)));
+    rank = std::max<int64_t>(1, rank);
+
+    const auto& bounds = bucketUpperMicros();
+    int64_t cumulative = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        cumulative += buckets_[i];
+        if (cumulative >= rank) {
+            return std::clamp(bounds[i], minMicros_, maxMicros_);
+        }
+    }
+    return maxMicros_;
+}
+
+SessionRunStats SessionRunStatsRecorder::snapshot(const std::string& sessionKey) const {
+    SessionRunStats stats;
+    stats.sessionKey = sessionKey;
+    stats.runs = runs_;
+    stats.totalMicros = totalMicros_;
+    stats.minMicros = minMicros_;
+    stats.maxMicros = maxMicros_;
+    stats.p50Micros = percentileMicros(0.50);
+    stats.p95Micros = percentileMicros(0.95);
+    stats.p99Micros = percentileMicros(0.99);
+    stats.inputBytes = inputBytes_;
+    stats.outputBytes = outputBytes_;
+    return stats;
+}
+
+std::string SessionRunStats::toJson(const std::vector<SessionRunStats>& stats) {
+    json result = json::array();
+    for (const auto& entry: stats) {
+        result.push_back({
+                { "session", entry.sessionKey },
+                { "runs", entry.runs },
+                { "totalUs", entry.totalMicros },
+                { "minUs", entry.minMicros },
+                { "maxUs", entry.maxMicros },
+                { "p50Us", entry.p50Micros },
+                { "p95Us", entry.p95Micros },
+                { "p99Us", entry.p99Micros },
+                { "inputBytes", entry.inputBytes },
+                { "outputBytes", entry.outputBytes },
+        });
+    }
+    return result.dump();
+}
@@ -0,0 +1,57 @@
+#ifndef AIDEO_SESSION_RUN_STATS_H
+#define AIDEO_SESSION_RUN_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 세션 키 하나의 Session::Run 누적 통계 스냅샷
+struct SessionRunStats {
+    std::string sessionKey;
+    int64_t runs = 0;
+    int64_t totalMicros = 0;
+    int64_t minMicros = 0;
+    int64_t maxMicros = 0;
+    // histogram bucket 상한 기준 근사값 (오차 약 ±10%)
+    int64_t p50Micros = 0;
+    int64_t p95Micros = 0;
+    int64_t p99Micros = 0;
+    // 입력/출력 텐서 크기 합
+    int64_t inputBytes = 0;
+    int64_t outputBytes = 0;
+
+    // JNI 로 전달할 compact JSON 배열
+    static std::string toJson(const std::vector<SessionRunStats>& stats);
+};
+
+/**
+ * Run 1회마다 호출되는 누적기 — 고정 크기 log-scale histogram 이라 기록 시 할당이 없음
+ *
+ * 동기화하지 않음 (호출 측이 lock 으로 보호)
+ */
+class SessionRunStatsRecorder {
+public:
+    void record(int64_t elapsedMicros, int64_t inputBytes, int64_t outputBytes);
+
+    SessionRunStats snapshot(const std::string& sessionKey) const;
+
+private:
+    // bucket i 의 상한 = 1.2^i us → 96 개로 약 33 초까지
+    static constexpr int kBucketCount = 96;
+
+    static const std::array<int64_t, kBucketCount>& bucketUpperMicros();
+
+    // [quantile] (0~1) 에 해당하는 bucket 의 상한 (min/max 범위로 보정)
+    int64_t percentileMicros(double quantile) const;
+
+    int64_t runs_ = 0;
+    int64_t totalMicros_ = 0;
+    int64_t minMicros_ = 0;
+    int64_t maxMicros_ = 0;
+    int64_t inputBytes_ = 0;
+    int64_t outputBytes_ = 0;
+    std::array<int64_t, kBucketCount> buckets_{};
+};
+
+#endif
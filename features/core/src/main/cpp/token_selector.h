@@ -2,7 +2,20 @@
 #define AIDEO_TOKEN_SELECTOR_H
 
 #include <cstdint>
-#include <vector>
+
+/**
+ * ORT 출력 버퍼 위의 logits 를 복사 없이 가리키는 view (소유하지 않음)
+ *
+ * [batch_size, decoder_seq_len, vocab_size] 를 [rows, vocabSize] 로 봄. 출력 버퍼가 유효한 동안만 사용
+ */
+struct LogitsView {
+    const float* data = nullptr;
+    int64_t rows = 0;
+    int64_t vocabSize = 0;
+
+    // 마지막 row (decoder 마지막 입력 토큰의 vocab 점수)
+    const float* lastRow() const { return data + (rows - 1) * vocabSize; }
+};
 
 // [logits → 다음 토큰] 변환 전략
 class TokenSelector {
@@ -11,14 +24,12 @@ public:
 
     /**
      * logits 로 부터 Token ID selector
-     * @param logits : shape = [batch_size, decoder_seq_len, vocab_size]
-     * @param vocabSize : vocab 크기
+     * @param logits : ORT 출력 버퍼의 view. 호출이 끝난 뒤에는 참조하지 않아야 함 (할당 없이 읽기만)
      * @param fallbackTokenId : logits 가 비었거나 비정상일 때, 반환할 토큰(default = eosTokenId)
      * @return
      */
     virtual int64_t select(
-            const std::vector<float>& logits,
-            int64_t vocabSize,
+            const LogitsView& logits,
             int64_t fallbackTokenId
     ) const = 0;
 };
@@ -26,8 +37,7 @@ public:
 class GreedyTokenSelector : public TokenSelector {
 public:
     int64_t select(
-            const std::vector<float>& logits,
-            int64_t vocabSize,
+            const LogitsView& logits,
             int64_t fallbackTokenId
     ) const override;
 };
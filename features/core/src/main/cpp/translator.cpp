@@ -2,6 +2,8 @@
 
 Translator::~Translator() = default;
 
+void Translator::cancel() {}
+
 void Translator::release() {
     isLoaded_ = false;
 }
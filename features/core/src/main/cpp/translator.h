@@ -1,6 +1,7 @@
 #ifndef AIDEO_TRANSLATOR_H
 #define AIDEO_TRANSLATOR_H
 
+#include <atomic>
 #include <string>
 #include "logging.h"
 
@@ -26,6 +27,13 @@ public:
             int maxLength = 256
     ) = 0;
 
+    /**
+     * 다른 스레드에서 진행 중인 translate() 를 중단
+     *
+     * 중단된 translate() 는 빈 문자열을 반환. 기본 구현은 아무것도 하지 않음 (중단 불가 모델)
+     */
+    virtual void cancel();
+
     virtual void release();
 
     bool isLoaded() const { return isLoaded_; }
@@ -36,7 +44,8 @@ public:
 protected:
     void setLoaded(bool v) { isLoaded_ = v; }
 
-    bool isLoaded_ = false;
+    // 모델 교체는 번역과 다른 스레드에서 진행될 수 있음
+    std::atomic<bool> isLoaded_{ false };
 };
 
 #endif
@@ -4,6 +4,12 @@ import java.nio.ByteBuffer
 
 class M2M100Native {
     external fun initialize(): Boolean
+
+    /**
+     * 이미 로드된 모델이 있으면 새 모델을 준비하는 동안 기존 모델로 계속 번역하고, 준비가 끝나면 교체
+     *
+     * 기존 모델을 사용 중인 번역이 끝날 때까지 반환하지 않으며, 실패하면 기존 모델을 유지. loadMergedModel / loadBestModelVariant 도 동일
+     */
     external fun loadModel(
         encoderPath: String,
         decoderPath: String,
@@ -13,14 +19,125 @@ class M2M100Native {
         tokenizerConfigPath: String
     ): Boolean
 
+    /**
+     * decoder / decoder_with_past 대신 Optimum merged decoder(use_cache_branch) 하나로 로드
+     */
+    external fun loadMergedModel(
+        encoderPath: String,
+        mergedDecoderPath: String,
+        spModelPath: String,
+        vocabPath: String,
+        tokenizerConfigPath: String
+    ): Boolean
+
+    /**
+     * [modelDirectory] 의 "<modelPrefix>_<role>.<variant>.onnx" variant(fp16, int8, int4 ...) 중 가장 빠른 variant 로 로드
+     *
+     * 첫 실행에서 variant 별 짧은 벤치마크를 수행해 [selectionPath] 에 저장하고, 이후에는 저장된 결과를 사용
+     * @return 로드한 variant 이름, 실패 시 null
+     */
+    external fun loadBestModelVariant(
+        modelDirectory: String,
+        modelPrefix: String,
+        selectionPath: String,
+        spModelPath: String,
+        vocabPath: String,
+        tokenizerConfigPath: String
+    ): String?
+
+    /**
+     * @param requestId : 요청마다 새로 발급한 0 이 아닌 id. [cancel] 로 이 요청만 중단할 때 사용
+     */
     external fun translateWithBuffer(
         textBuffer: ByteBuffer,
         textLength: Int,
         srcLang: String,
         tgtLang: String,
-        maxLength: Int
+        maxLength: Int,
+        requestId: Long
     ): String?
 
+    /**
+     * 다른 스레드에서 실행 중인 [requestId] 의 translateWithBuffer 만 중단 (중단된 호출은 null 반환)
+     *
+     * 아직 시작되지 않은 요청이면 시작하는 즉시 중단됨
+     */
+    external fun cancel(requestId: Long)
+
+    /**
+     * 세션 EP 구성 선택. 다음 loadModel 부터 적용
+     *
+     * @param provider : "cpu" 또는 "xnnpack" (XNNPACK 미지원 노드는 CPU 로 fallback)
+     * @param xnnpackThreads : XNNPACK 자체 스레드 수 (0 이하면 기본값)
+     * @return 알 수 없는 provider 면 false
+     */
+    external fun setExecutionProvider(provider: String, xnnpackThreads: Int): Boolean
+
+    /**
+     * 토큰마다 실행되는 decoder 세션의 intra-op 워커 코어 배치. 다음 loadModel 부터 적용
+     *
+     * @param mode : "none", "fastest"(최대 주파수가 높은 클러스터) 또는 "cores"
+     * @param cores : "cores" 에서 고정할 logical CPU id (0 부터)
+     * @return 알 수 없는 mode 면 false
+     */
+    external fun setThreadAffinity(mode: String, cores: IntArray?): Boolean
+
+    /**
+     * 토큰마다 실행되는 decoder 세션을 [threadLevels] 스레드 수별로 준비해 두고,
+     * 발열/동시 작업으로 step 시간이 변하면 더 빠른 스레드 수로 전환. 다음 loadModel 부터 적용
+     *
+     * @param threadLevels : 후보 스레드 수 (예: [1, 2, 4]), null 또는 빈 배열이면 끔
+     */
+    external fun setAdaptiveThreading(threadLevels: IntArray?)
+
+    /**
+     * 로드된 모델과 같은 모델을 따로 로드해 배치 없음 / [mode] 배치의 decode step 시간을 비교 (측정 중에도 번역 가능)
+     *
+     * @return [unpinnedStepMs, pinnedStepMs] (실패한 항목은 음수), 로드 전이거나 알 수 없는 mode 면 null
+     */
+    external fun benchmarkThreadAffinity(mode: String, cores: IntArray?): DoubleArray?
+
+    /**
+     * 자막 한 줄 길이 문장에서 cross-attention K/V 를 첫 step 에 한 번 계산해 고정 바인딩하는 효과 측정
+     *
+     * @return [pinnedBytes(문장당 고정 크기), savedBytesPerStep(step 마다 줄어든 출력/복사 크기), stepMs], 로드 전이면 null
+     */
+    external fun benchmarkCrossAttention(): DoubleArray?
+
+    /**
+     * ONNX 세션 메모리 예산 (0 이하면 무제한)
+     *
+     * 초과 시 사용 중이 아닌 세션을 오래전에 사용한 순서로 축출하고, 다음 번역에서 다시 로드
+     */
+    external fun setSessionMemoryBudget(budgetBytes: Long)
+
+    /**
+     * 세션 캐시 통계
+     * @return [hits, misses, evictions, residentBytes, memoryBudgetBytes, residentSessions, registeredSessions], 초기화 전이면 null
+     */
+    external fun getSessionCacheStats(): LongArray?
+
+    /**
+     * 이후 번역에서 encoder / decoder / decoder_with_past 세션별로 [maxRuns] 회 ORT profiling 수행
+     *
+     * trace JSON 은 [outputDirectory] 에 세션 키 prefix 로 기록됨
+     */
+    external fun startProfiling(outputDirectory: String, maxRuns: Int, topOpCount: Int): Boolean
+
+    /**
+     * profiling 이 끝난 세션별 상위 op 집계
+     * @return [{"session", "profile", "runs", "totalKernelUs", "topOps": [{"op", "us", "calls", "share"}]}] 형식의 JSON
+     */
+    external fun getProfilingSummary(): String?
+
+    /**
+     * 마지막 resetRunStats 이후 세션별 Session::Run 통계 (번역 시간 중 ORT 실행 비중 확인용)
+     * @return [{"session", "runs", "totalUs", "minUs", "maxUs", "p50Us", "p95Us", "p99Us", "inputBytes", "outputBytes"}] 형식의 JSON
+     */
+    external fun getRunStats(): String?
+
+    external fun resetRunStats()
+
     external fun release()
 
     companion object {
@@ -9,7 +9,13 @@ import jinproject.aideo.core.inference.translation.api.Translation
 import jinproject.aideo.core.utils.LanguageCode
 import jinproject.aideo.core.utils.copyAssetToInternalStorage
 import jinproject.aideo.core.utils.getPackAssetPath
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.coroutineScope
+import java.io.File
 import java.nio.ByteBuffer
+import java.util.concurrent.atomic.AtomicLong
 import javax.inject.Inject
 import javax.inject.Singleton
 import kotlin.text.Charsets.UTF_8
@@ -20,6 +26,8 @@ class M2M100 @Inject constructor(
     private var m2M100Native: M2M100Native? = null
     private var textBuffer: ByteBuffer? = null
     private var batchBuffer: ByteBuffer? = null
+    // native cancel 이 취소된 요청만 중단하도록 요청마다 발급 (0 은 native 에서 "id 없음")
+    private val nextRequestId = AtomicLong()
 
     override val availableTranslation: TranslationAvailableModel = TranslationAvailableModel.M2M100
 
@@ -38,16 +46,19 @@ class M2M100 @Inject constructor(
         val tokenizerConfigInternalPath =
             copyAssetToInternalStorage(path = TOKENIZER_CONFIG_PATH, context = context)
 
-        val isModelLoaded = m2M100Native!!.loadModel(
-            encoderPath = "${context.getPackAssetPath(AiModelConfig.TRANSLATION_BASE_PACK)}/$ENCODER_MODEL_PATH",
-            decoderPath = "${context.getPackAssetPath(AiModelConfig.TRANSLATION_BASE_PACK)}/$DECODER_MODEL_PATH",
-            decoderWithPastPath = "${context.getPackAssetPath(AiModelConfig.TRANSLATION_BASE_PACK)}/$DECODER_WITH_PAST_MODEL_PATH",
-            spModelPath = "${context.getPackAssetPath(AiModelConfig.TRANSLATION_BASE_PACK)}/$SP_MODEL_PATH",
+        val packPath = context.getPackAssetPath(AiModelConfig.TRANSLATION_BASE_PACK)
+
+        // pack 에 포함된 가중치 형식(fp16, int8, int4 ...) 중 이 기기에서 가장 빠른 variant 를 native 에서 선택
+        val loadedVariant = m2M100Native!!.loadBestModelVariant(
+            modelDirectory = "$packPath/$MODELS_ROOT_DIR",
+            modelPrefix = M2M100,
+            selectionPath = File(context.filesDir, VARIANT_SELECTION_FILE).absolutePath,
+            spModelPath = "$packPath/$SP_MODEL_PATH",
             vocabPath = vocabInternalPath,
             tokenizerConfigPath = tokenizerConfigInternalPath,
         )
 
-        if (!isModelLoaded) {
+        if (loadedVariant == null) {
             m2M100Native = null
             return
         }
@@ -60,13 +71,26 @@ class M2M100 @Inject constructor(
         srcLang: LanguageCode,
         tgtLang: LanguageCode,
         maxLength: Int,
-    ): String {
-        return translateWithBuffer(
-            text = text.toByteArray(UTF_8),
-            sourceLanguageCode = srcLang,
-            targetLanguageCode = tgtLang,
-            maxLength = maxLength
-        )
+    ): String = coroutineScope {
+        val requestId = nextRequestId.incrementAndGet()
+        val translation = async(Dispatchers.Default) {
+            translateWithBuffer(
+                text = text.toByteArray(UTF_8),
+                sourceLanguageCode = srcLang,
+                targetLanguageCode = tgtLang,
+                maxLength = maxLength,
+                requestId = requestId
+            )
+        }
+
+        try {
+            translation.await()
+        } catch (e: CancellationException) {
+            // JNI 호출은 코루틴 취소로 멈추지 않으므로 native 측 Session::Run 을 직접 중단
+            // 다른 코루틴의 번역은 계속 진행. native 호출 전이어도 시작하는 즉시 중단됨
+            m2M100Native?.cancel(requestId)
+            throw e
+        }
     }
 
     /*
@@ -120,6 +144,7 @@ class M2M100 @Inject constructor(
         sourceLanguageCode: LanguageCode,
         targetLanguageCode: LanguageCode,
         maxLength: Int = MAX_OUTPUT_LENGTH,
+        requestId: Long,
     ): String {
         if (textBuffer == null || textBuffer!!.capacity() < text.size)
             textBuffer = ByteBuffer.allocateDirect(text.size)
@@ -134,10 +159,21 @@ class M2M100 @Inject constructor(
             textLength = text.size,
             srcLang = sourceLanguageCode.code,
             tgtLang = targetLanguageCode.code,
-            maxLength = maxLength
+            maxLength = maxLength,
+            requestId = requestId
         ) ?: throw IllegalStateException("Translation failed")
     }
 
+    /**
+     * 번역 세션이 상주할 수 있는 메모리 예산 설정
+     *
+     * ASR 처럼 번역을 쓰지 않는 구간에 낮춰 두면 유휴 번역 세션이 축출되고, 다음 번역 시 다시 로드됨
+     * @param budgetBytes : 0 이하면 무제한
+     */
+    fun setSessionMemoryBudget(budgetBytes: Long) {
+        m2M100Native?.setSessionMemoryBudget(budgetBytes)
+    }
+
     override fun release() {
         super.release()
 
@@ -152,13 +188,10 @@ class M2M100 @Inject constructor(
 
     companion object {
         const val M2M100 = "m2m100"
-        const val ENCODER_MODEL_PATH = "$MODELS_ROOT_DIR/${M2M100}_encoder.int8.onnx"
-        const val DECODER_MODEL_PATH = "$MODELS_ROOT_DIR/${M2M100}_decoder.int8.onnx"
-        const val DECODER_WITH_PAST_MODEL_PATH =
-            "$MODELS_ROOT_DIR/${M2M100}_decoder_with_past.int8.onnx"
         const val SP_MODEL_PATH = "$MODELS_ROOT_DIR/${M2M100}_sentencepiece.bpe.model"
         const val VOCAB_PATH = "$MODELS_ROOT_DIR/${M2M100}_vocab.json"
         const val TOKENIZER_CONFIG_PATH = "$MODELS_ROOT_DIR/${M2M100}_tokenizer_config.json"
+        private const val VARIANT_SELECTION_FILE = "${M2M100}_variant_selection.json"
 
         private const val MAX_TEXT_BUFFER_SIZE = 1024
         private const val MAX_OUTPUT_LENGTH = 200